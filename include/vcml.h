@@ -31,8 +31,12 @@
 
 #include "vcml/logging/logger.h"
 #include "vcml/logging/log_file.h"
+#include "vcml/logging/log_limiter.h"
 #include "vcml/logging/log_stream.h"
 #include "vcml/logging/log_term.h"
+#include "vcml/logging/log_writer.h"
+#include "vcml/logging/trace_file.h"
+#include "vcml/logging/trace_predicate.h"
 
 #include "vcml/properties/property_base.h"
 #include "vcml/properties/property.h"
@@ -52,6 +56,7 @@
 #include "vcml/elf.h"
 #include "vcml/range.h"
 #include "vcml/sbi.h"
+#include "vcml/atomic.h"
 #include "vcml/exmon.h"
 #include "vcml/ports.h"
 #include "vcml/stubs.h"
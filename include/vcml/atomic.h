@@ -0,0 +1,84 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_ATOMIC_H
+#define VCML_ATOMIC_H
+
+#include "vcml/common/types.h"
+#include "vcml/common/report.h"
+#include "vcml/common/systemc.h"
+
+namespace vcml {
+
+    enum vcml_atomic_op {
+        VCML_ATOMIC_NONE = 0,
+        VCML_ATOMIC_SWAP,
+        VCML_ATOMIC_CAS,
+        VCML_ATOMIC_ADD,
+        VCML_ATOMIC_AND,
+        VCML_ATOMIC_OR,
+        VCML_ATOMIC_XOR,
+        VCML_ATOMIC_MIN,
+        VCML_ATOMIC_MAX,
+        VCML_ATOMIC_MINU,
+        VCML_ATOMIC_MAXU,
+    };
+
+    const char* atomic_op_to_str(vcml_atomic_op op);
+
+    // Turns a write transaction into an atomic read-modify-write: the data
+    // buffer holds the operand and receives the previous memory contents.
+    // Targets that understand the extension must set ack. Initiators first
+    // send a TLM_IGNORE_COMMAND probe, which such targets acknowledge without
+    // executing it, so that unaware targets never see the store.
+    class atomicext: public tlm_extension<atomicext>
+    {
+    public:
+        vcml_atomic_op op;
+        u64 compare; // expected memory contents for VCML_ATOMIC_CAS
+        bool ack;
+
+        atomicext(): op(VCML_ATOMIC_NONE), compare(0), ack(false) {}
+
+        virtual tlm_extension_base* clone() const override;
+        virtual void copy_from(const tlm_extension_base& ext) override;
+    };
+
+    inline const atomicext* tx_get_atomic(const tlm_generic_payload& tx) {
+        const atomicext* ext = tx.get_extension<atomicext>();
+        return ext != nullptr && ext->op != VCML_ATOMIC_NONE ? ext : nullptr;
+    }
+
+    inline atomicext* tx_get_atomic(tlm_generic_payload& tx) {
+        atomicext* ext = tx.get_extension<atomicext>();
+        return ext != nullptr && ext->op != VCML_ATOMIC_NONE ? ext : nullptr;
+    }
+
+    inline bool atomic_supported(u64 addr, unsigned int size) {
+        return (size == 1 || size == 2 || size == 4 || size == 8) &&
+               (addr & (size - 1)) == 0;
+    }
+
+    // executes op on naturally aligned host memory using host atomics, the
+    // previous memory contents are returned via data
+    void atomic_execute(vcml_atomic_op op, void* mem, void* data,
+                        unsigned int size, u64 compare = 0);
+
+}
+
+#endif
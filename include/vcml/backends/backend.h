@@ -67,7 +67,7 @@ namespace vcml {
                 return;                                       \
             va_list args;                                     \
             va_start(args, format);                           \
-            logger::log(level, name(), vmkstr(format, args)); \
+            logger::log(level, this, vmkstr(format, args));   \
             va_end(args);                                     \
         }
 
@@ -81,6 +81,12 @@ namespace vcml {
     using sc_core::sc_pause;
     #endif
 
+    #if (SYSTEMC_VERSION < 20120701)
+    inline sc_time sc_time_to_pending_activity() { return SC_ZERO_TIME; }
+    #else
+    using sc_core::sc_time_to_pending_activity;
+    #endif
+
     using sc_core::sc_simcontext;
     using sc_core::sc_get_curr_simcontext;
 
@@ -20,6 +20,9 @@
 #define VCML_THCTL_H
 
 #include <pthread.h>
+#include <exception>
+
+#include "vcml/common/types.h"
 
 namespace vcml {
 
@@ -33,6 +36,60 @@ namespace vcml {
     void thctl_suspend();
     void thctl_resume();
 
+    // A thctl_worker executes jobs on a host thread on behalf of a SystemC
+    // thread. While a job is running, the worker may hand back any work
+    // that needs SystemC context via request(), which blocks the worker
+    // until its owner has executed it using run_request() and resumed it.
+    class thctl_worker
+    {
+    private:
+        enum worker_state {
+            WORKER_IDLE,
+            WORKER_READY,
+            WORKER_RUNNING,
+            WORKER_REQUEST,
+            WORKER_DONE,
+            WORKER_EXIT,
+        };
+
+        string               m_name;
+        pthread_t            m_thread;
+        pthread_mutex_t      m_mutex;
+        pthread_cond_t       m_notify;
+        atomic<worker_state> m_state;
+        function<void()>     m_job;
+        function<void()>     m_request;
+        std::exception_ptr   m_error;
+
+        void wait_state(worker_state state);
+        void set_state(worker_state state);
+        void work();
+
+        static void* thread_func(void* arg);
+
+    public:
+        const char* name() const { return m_name.c_str(); }
+
+        bool is_idle()    const { return m_state == WORKER_IDLE; }
+        bool is_ready()   const { return m_state == WORKER_READY; }
+        bool is_request() const { return m_state == WORKER_REQUEST; }
+        bool is_done()    const { return m_state == WORKER_DONE; }
+
+        thctl_worker(const string& name);
+        virtual ~thctl_worker();
+
+        void start(const function<void()>& job);
+        void resume();
+        void join();
+        void finish();
+
+        void request(const function<void()>& func);
+        void run_request();
+    };
+
+    thctl_worker* thctl_current_worker();
+    bool          thctl_is_worker_thread();
+
     class thctl_guard
     {
     private:
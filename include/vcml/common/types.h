@@ -39,6 +39,7 @@
 #include <fstream>
 #include <memory>
 #include <functional>
+#include <typeinfo>
 #include <atomic>
 
 namespace vcml {
@@ -44,7 +44,14 @@ namespace vcml {
         friend class slave_socket;
     private:
         clock_t m_curclk;
+
+        // local time offsets of the processes that use this component, the
+        // map keeps references stable and the last lookup gets cached
         std::unordered_map<sc_process_b*, sc_time> m_offsets;
+        sc_process_b* m_last_proc;
+        sc_time*      m_last_offset;
+
+        sc_time& offset_slot(sc_process_b* proc);
 
         vector<master_socket*> m_master_sockets;
         vector<slave_socket*> m_slave_sockets;
@@ -64,6 +71,9 @@ namespace vcml {
 
     public:
         property<bool> allow_dmi;
+        property<bool> dmi_prefetch;
+        property<bool> mmio_dmi;
+        property<u64> exmon_granule;
 
         in_port<clock_t> CLOCK;
         in_port<bool>    RESET;
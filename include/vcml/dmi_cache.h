@@ -27,22 +27,28 @@
 
 namespace vcml {
 
+    // dmi_cache keeps its entries sorted and guarantees that no two entries
+    // overlap. Entries are keyed by their end address, so lookup, insert and
+    // invalidate only touch the entries around the affected address range.
+    // Lookups first check the most recently used entry, since consecutive
+    // accesses are likely to hit the same region again.
     class dmi_cache
     {
     private:
-        size_t m_limit;
-        vector<tlm_dmi> m_entries;
+        typedef std::map<u64, tlm_dmi> entry_map;
 
-        void cleanup();
+        entry_map m_entries;
+        entry_map::iterator m_mru;
 
-    public:
-        size_t get_entry_limit() const     { return m_limit; }
-        void   set_entry_limit(size_t lim) { m_limit = lim; }
+        void carve(const range& r);
 
-        vector<tlm_dmi>& get_entries() { return m_entries; }
-        const vector<tlm_dmi> get_entries() const { return m_entries; }
+    public:
+        size_t get_num_entries() const { return m_entries.size(); }
+        vector<tlm_dmi> get_entries() const;
 
         dmi_cache();
+        dmi_cache(const dmi_cache&) = delete;
+        dmi_cache& operator = (const dmi_cache&) = delete;
         virtual ~dmi_cache();
 
         void insert(const tlm_dmi& dmi);
@@ -50,6 +56,8 @@ namespace vcml {
         void invalidate(u64 start, u64 end);
         void invalidate(const range& r);
 
+        bool overlaps(const range& r) const;
+
         bool lookup(const range& r, tlm_command c, tlm_dmi& dmi);
         bool lookup(u64 addr, u64 size, tlm_command c, tlm_dmi& dmi);
         bool lookup(const tlm_generic_payload& tx, tlm_dmi& dmi);
@@ -20,6 +20,7 @@
 #define VCML_EXMON_H
 
 #include "vcml/common/types.h"
+#include "vcml/common/bitops.h"
 #include "vcml/common/report.h"
 #include "vcml/common/systemc.h"
 
@@ -37,19 +38,38 @@ namespace vcml {
     class exmon
     {
     private:
+        // reservation granule size and its log2
+        u64 m_granule;
+        int m_shift;
+
+        // per-cpu reservations, each covering whole granules
         vector<exlock> m_locks;
 
+        // number of reservations per granule, for quick conflict checks
+        std::unordered_map<u64, unsigned int> m_granules;
+
+        void reserve(const range& r);
+        void release(const range& r);
+
     public:
         inline const vector<exlock> get_locks() const {
             return m_locks;
         }
 
-        exmon();
+        u64 get_granule() const { return m_granule; }
+        void set_granule(u64 granule);
+
+        range align(const range& r) const;
+
+        exmon(u64 granule = 64);
         virtual ~exmon();
 
+        bool has_locks() const { return !m_locks.empty(); }
         bool has_lock(int cpu, const range& r) const;
         bool add_lock(int cpu, const range& r);
 
+        bool conflicts(const range& r) const;
+
         void break_locks(int cpu);
         void break_locks(const range& r);
 
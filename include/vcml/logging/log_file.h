@@ -22,21 +22,28 @@
 #include "vcml/common/types.h"
 #include "vcml/common/strings.h"
 #include "vcml/logging/logger.h"
+#include "vcml/logging/log_writer.h"
 
 namespace vcml {
 
     class log_file: public logger
     {
     private:
-        ofstream m_file;
+        log_writer m_writer;
 
     public:
         log_file(const string& filename);
         virtual ~log_file();
 
         virtual void log_line(log_level lvl, const char* line);
+
+        inline void flush();
     };
 
+    inline void log_file::flush() {
+        m_writer.flush();
+    }
+
 }
 
 #endif
@@ -0,0 +1,75 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_LOG_LIMITER_H
+#define VCML_LOG_LIMITER_H
+
+#include <pthread.h>
+
+#include "vcml/common/types.h"
+#include "vcml/common/strings.h"
+#include "vcml/common/utils.h"
+#include "vcml/common/systemc.h"
+
+#include "vcml/logging/logger.h"
+
+namespace vcml {
+
+    // Token bucket rate limiter for log messages, keyed by the format string
+    // of the call site. Messages that exceed the rate get dropped and are
+    // summarized once the next message of the same call site gets through,
+    // or by a host thread that calls flush_all() once per second. The clock
+    // returns host time in seconds and can be replaced for testing.
+    class log_limiter
+    {
+    private:
+        struct bucket {
+            double tokens;
+            double stamp;
+            u64 suppressed;
+            log_level level;
+        };
+
+        const sc_object* m_obj;
+        string m_org;
+        function<double()> m_clock;
+
+        pthread_mutex_t m_mutex;
+        std::unordered_map<const char*, bucket> m_buckets;
+
+        void report(log_level lvl, u64 suppressed) const;
+
+    public:
+        log_limiter(const sc_object* org,
+                    const function<double()>& clock = &realtime);
+        log_limiter(const string& org,
+                    const function<double()>& clock = &realtime);
+        virtual ~log_limiter();
+
+        log_limiter() = delete;
+        log_limiter(const log_limiter&) = delete;
+
+        bool allow(log_level lvl, const char* format, unsigned int rate);
+        void flush();
+
+        static void flush_all();
+    };
+
+}
+
+#endif
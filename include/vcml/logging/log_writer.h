@@ -0,0 +1,81 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_LOG_WRITER_H
+#define VCML_LOG_WRITER_H
+
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "vcml/common/types.h"
+#include "vcml/common/strings.h"
+
+namespace vcml {
+
+    // Writes log lines asynchronously: producers push lines into a lock-free
+    // multi-producer single-consumer queue, which a writer thread drains
+    // using large writes at least every 10ms.
+    // All writers are flushed on exit() and on abort().
+    class log_writer
+    {
+    private:
+        struct line {
+            atomic<line*> next;
+            size_t size;
+            char text[1];
+        };
+
+        int   m_fd;
+        bool  m_owner;
+        line  m_stub;
+        line* m_tail;
+
+        atomic<line*> m_head;
+        atomic<u64>   m_pushed;
+        atomic<u64>   m_written;
+        atomic<bool>  m_running;
+
+        sem_t     m_notify;
+        pthread_t m_thread;
+        string    m_buffer;
+
+        void setup();
+        void write_buffer();
+        void drain();
+        void writer();
+
+        static void* thread_func(void* arg);
+
+    public:
+        log_writer(int fd);
+        log_writer(const string& filename);
+        virtual ~log_writer();
+
+        log_writer() = delete;
+        log_writer(const log_writer&) = delete;
+
+        void write_line(const char* text, const char* prefix = "",
+                        const char* suffix = "");
+        void flush();
+
+        static void flush_all();
+    };
+
+}
+
+#endif
@@ -53,8 +53,10 @@ namespace vcml {
 
         static vector<logger*> loggers[NUM_LOG_LEVELS];
 
-        static void print_prefix(ostream& os, log_level lvl, const sc_time& t);
-        static void print_trace(bool forward, const string& org,
+        static void print_prefix(string& buf, log_level lvl, const sc_time& t);
+        static void print_lines(log_level lvl, const char* org,
+                                const sc_time& t, const string& msg);
+        static void print_trace(bool forward, const char* org,
                                 const tlm_generic_payload& tx,
                                 const sc_time& dt);
 
@@ -72,11 +74,14 @@ namespace vcml {
         static bool would_log(log_level lvl);
 
         static void log(log_level lvl, const string& org, const string& msg);
+        static void log(log_level lvl, const sc_object* org, const string& msg);
         static void log(const report& rep);
 
-        static void trace_fw(const string& org, const tlm_generic_payload& tx,
+        static bool check_rate(log_level lvl, const char* format);
+
+        static void trace_fw(const char* org, const tlm_generic_payload& tx,
                              const sc_time& dt);
-        static void trace_bw(const string& org, const tlm_generic_payload& tx,
+        static void trace_bw(const char* org, const tlm_generic_payload& tx,
                              const sc_time& dt);
 
         static bool print_time_stamp;
@@ -84,7 +89,10 @@ namespace vcml {
         static bool print_origin;
         static bool print_backtrace;
 
+        static unsigned int log_rate;
+
         static size_t trace_name_length;
+        static string trace_filter;
 
         static const char* prefix[NUM_LOG_LEVELS];
         static const char* desc[NUM_LOG_LEVELS];
@@ -102,9 +110,13 @@ namespace vcml {
     inline void name(const char* format, ...) {                  \
         if (!logger::would_log(level))                           \
             return;                                              \
+        if (logger::log_rate > 0 &&                              \
+            !logger::check_rate(level, format))                  \
+            return;                                              \
+        string origin = call_origin();                           \
         va_list args;                                            \
         va_start(args, format);                                  \
-        logger::log(level, call_origin(), vmkstr(format, args)); \
+        logger::log(level, origin, vmkstr(format, args));        \
         va_end(args);                                            \
     }
 
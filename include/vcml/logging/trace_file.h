@@ -0,0 +1,81 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_TRACE_FILE_H
+#define VCML_TRACE_FILE_H
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include "vcml/common/types.h"
+#include "vcml/common/strings.h"
+#include "vcml/common/report.h"
+#include "vcml/common/systemc.h"
+#include "vcml/logging/trace_format.h"
+
+namespace vcml {
+
+    // Writes transaction traces as fixed-size binary records. Every thread
+    // records into its own lock-free ring buffer, which a background thread
+    // drains into the trace file. Use vcml-tracedec to convert the file to
+    // text or CSV.
+    class trace_file
+    {
+    private:
+        struct ring;
+
+        u64             m_id;
+        string          m_filename;
+        FILE*           m_file;
+        pthread_t       m_thread;
+        pthread_mutex_t m_mutex;
+        pthread_cond_t  m_notify;
+        atomic<bool>    m_running;
+
+        vector<ring*> m_rings;
+        std::unordered_map<string, u32> m_origins;
+
+        ring* local_ring();
+        u32 lookup_origin(ring* r, const char* org);
+
+        void push(ring* r, const trace_record& rec);
+        void drain(ring* r);
+        void writer();
+
+        static void* thread_func(void* arg);
+
+        static trace_file* s_instance;
+
+    public:
+        const char* filename() const { return m_filename.c_str(); }
+
+        trace_file(const string& filename);
+        virtual ~trace_file();
+
+        trace_file() = delete;
+        trace_file(const trace_file&) = delete;
+
+        void record(bool forward, const char* org,
+                    const tlm_generic_payload& tx, const sc_time& t);
+
+        static trace_file* instance() { return s_instance; }
+    };
+
+}
+
+#endif
@@ -0,0 +1,71 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_TRACE_FORMAT_H
+#define VCML_TRACE_FORMAT_H
+
+#include "vcml/common/types.h"
+
+namespace vcml {
+
+    // binary trace files start with a trace_header, followed by a stream of
+    // trace_records; origin names are defined by TRACE_RECORD_NAME records
+    // whose name bytes occupy the subsequent records, zero padded
+
+    const char TRACE_MAGIC[8] = { 'V', 'C', 'M', 'L', 'T', 'R', 'C', 0 };
+    const u32  TRACE_VERSION = 1;
+    const u32  TRACE_DATA_BYTES = 24;
+
+    enum trace_record_type {
+        TRACE_RECORD_TX = 0,
+        TRACE_RECORD_NAME = 1,
+    };
+
+    enum trace_record_flags {
+        TRACE_FLAG_FORWARD = 1 << 0,
+    };
+
+    struct trace_header {
+        char magic[8];
+        u32  version;
+        u32  record_size;
+    };
+
+    struct trace_record {
+        u64 time;     // simulation time stamp in nanoseconds
+        u64 delta;    // delta cycle count
+        u64 addr;     // transaction address
+        u32 origin;   // identifier of the tracing socket
+        u32 size;     // transaction data length, or name length
+        u8  type;     // trace_record_type
+        u8  flags;    // trace_record_flags
+        u8  command;  // tlm_command
+        i8  response; // tlm_response_status
+        u32 nbytes;   // number of valid bytes in data
+        u8  data[TRACE_DATA_BYTES];
+    };
+
+    static_assert(sizeof(trace_record) == 64, "unexpected trace record size");
+
+    inline u32 trace_name_records(u32 length) {
+        return (length + sizeof(trace_record) - 1) / sizeof(trace_record);
+    }
+
+}
+
+#endif
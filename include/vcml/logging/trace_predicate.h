@@ -0,0 +1,89 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_TRACE_PREDICATE_H
+#define VCML_TRACE_PREDICATE_H
+
+#include "vcml/common/types.h"
+#include "vcml/common/strings.h"
+#include "vcml/common/report.h"
+#include "vcml/common/systemc.h"
+
+#include "vcml/range.h"
+#include "vcml/sbi.h"
+
+namespace vcml {
+
+    // Compiled form of a trace filter specification, a comma separated list
+    // of "addr=<start>-<end>", "cpu=<id>", "read", "write" and "errors".
+    // Transactions are traced if they overlap any of the given address
+    // ranges, originate from any of the given cpus, match any of the given
+    // commands and, with "errors", failed. Omitted criteria match anything.
+    class trace_predicate
+    {
+    private:
+        bool m_reads;
+        bool m_writes;
+        bool m_errors;
+        u64  m_cpus;
+        vector<range> m_ranges;
+
+    public:
+        bool is_empty() const;
+
+        trace_predicate();
+        explicit trace_predicate(const string& spec);
+
+        void compile(const string& spec);
+
+        bool matches(const tlm_generic_payload& tx, bool forward) const;
+    };
+
+    inline bool trace_predicate::is_empty() const {
+        return m_reads && m_writes && !m_errors && m_cpus == ~0ull &&
+               m_ranges.empty();
+    }
+
+    inline bool trace_predicate::matches(const tlm_generic_payload& tx,
+                                         bool forward) const {
+        if (m_errors && (forward || !failed(tx)))
+            return false;
+
+        if ((tx.is_read() && !m_reads) || (tx.is_write() && !m_writes))
+            return false;
+
+        if (m_cpus != ~0ull) {
+            int cpu = tx_get_sbi(tx).cpuid;
+            if (cpu < 0 || cpu >= 64 || !(m_cpus & (1ull << cpu)))
+                return false;
+        }
+
+        if (m_ranges.empty())
+            return true;
+
+        range addr(tx);
+        for (const range& r : m_ranges)
+            if (r.overlaps(addr))
+                return true;
+
+        return false;
+    }
+
+}
+
+#endif
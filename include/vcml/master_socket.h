@@ -22,18 +22,41 @@
 #include "vcml/common/types.h"
 #include "vcml/common/report.h"
 #include "vcml/common/systemc.h"
+#include "vcml/common/thctl.h"
 
 #include "vcml/range.h"
 #include "vcml/sbi.h"
+#include "vcml/atomic.h"
 #include "vcml/dmi_cache.h"
 #include "vcml/component.h"
 #include "vcml/adapters.h"
 
 namespace vcml {
 
+    class mmioext;
+
     class master_socket: public simple_initiator_socket<master_socket, 64>
     {
+    public:
+        enum : u64 {
+            TLB_PAGE_BITS = 12,
+            TLB_PAGE_SIZE = 1ull << TLB_PAGE_BITS,
+            TLB_PAGE_MASK = TLB_PAGE_SIZE - 1,
+            TLB_ENTRIES = 256,
+            TLB_INVALID = ~0ull,
+        };
+
     private:
+        // Direct-mapped table of host pointers for zero-latency DMI pages,
+        // allowing readw and writew to skip the dmi_cache range search.
+        struct tlb_entry {
+            u64 rdtag;
+            u64 wrtag;
+            unsigned char* ptr;
+        };
+
+        tlb_entry m_tlb[TLB_ENTRIES];
+
         bool m_free;
         sc_event m_free_ev;
 
@@ -47,8 +70,36 @@ namespace vcml {
         sc_module* m_adapter;
         component* m_host;
 
+        // ranges invalidated since the last DMI prefetch
+        vector<range> m_prefetch;
+
+        // direct handles to target sockets granted via MMIO-DMI, keyed by
+        // the end address of the region they cover
+        struct mmio_handle {
+            range addr;
+            u64 offset;
+            slave_socket* socket;
+        };
+
+        std::map<u64, mmio_handle> m_mmio;
+
+        void map_mmio(u64 addr, const tlm_dmi& dmi, const mmioext& ext);
+        void unmap_mmio(u64 start, u64 end);
+
+        bool transport_mmio(tlm_generic_payload& tx, sc_time& dt);
+
         void invalidate_direct_mem_ptr(sc_dt::uint64 start, sc_dt::uint64 end);
 
+        void tlb_fill(u64 addr, const tlm_dmi& dmi);
+        void tlb_flush(u64 start, u64 end);
+        void tlb_flush();
+
+        unsigned char* tlb_lookup(u64 addr, unsigned int size, bool write,
+                                  const sideband& info) const;
+
+    protected:
+        virtual void end_of_elaboration() override;
+
     public:
         int  get_cpuid() const  { return m_sbi.cpuid; }
         int  get_level() const  { return m_sbi.level; }
@@ -63,10 +114,15 @@ namespace vcml {
         VCML_KIND(master_socket);
 
         dmi_cache& dmi();
+        const dmi_cache& dmi() const;
 
         void map_dmi(const tlm_dmi& dmi);
         void unmap_dmi(u64 start, u64 end);
 
+        void prefetch_dmi(u64 start = 0, u64 end = ~0ull);
+
+        size_t get_num_mmio_handles() const { return m_mmio.size(); }
+
         unsigned int send(tlm_generic_payload& tx,
                           const sideband& info = SBI_NONE);
 
@@ -74,6 +130,20 @@ namespace vcml {
                                        unsigned int size,
                                        const sideband& info = SBI_NONE);
 
+        tlm_response_status atomic_dmi(vcml_atomic_op op, u64 addr,
+                                       void* data, unsigned int size,
+                                       u64 compare = 0,
+                                       const sideband& info = SBI_NONE);
+
+        tlm_response_status atomic (vcml_atomic_op op, u64 addr, void* data,
+                                    unsigned int size, u64 compare = 0,
+                                    const sideband& info = SBI_NONE);
+
+        template <typename T>
+        tlm_response_status atomicw(vcml_atomic_op op, u64 addr, T& data,
+                                    T compare = T(),
+                                    const sideband& info = SBI_NONE);
+
         tlm_response_status access (tlm_command cmd, u64 addr, void* data,
                                     unsigned int size,
                                     const sideband& info = SBI_NONE,
@@ -119,16 +189,42 @@ namespace vcml {
         VCML_ERROR_ON(m_sbi.level != level, "level too large");
     }
 
+    inline unsigned char* master_socket::tlb_lookup(u64 addr,
+            unsigned int size, bool write, const sideband& info) const {
+        if (info.is_debug || info.is_nodmi || info.is_excl || info.is_sync)
+            return nullptr;
+
+        const u64 page = addr >> TLB_PAGE_BITS;
+        const u64 offset = addr & TLB_PAGE_MASK;
+        if (offset + size > TLB_PAGE_SIZE || !m_host->allow_dmi)
+            return nullptr;
+
+        const tlb_entry& entry = m_tlb[page % TLB_ENTRIES];
+        if ((write ? entry.wrtag : entry.rdtag) != page)
+            return nullptr;
+
+        return entry.ptr + offset;
+    }
+
     inline dmi_cache& master_socket::dmi() {
+        tlb_flush(); // caller may modify the cache behind our back
+        return m_dmi_cache;
+    }
+
+    inline const dmi_cache& master_socket::dmi() const {
         return m_dmi_cache;
     }
 
     inline void master_socket::map_dmi(const tlm_dmi& dmi) {
+        tlb_flush(dmi.get_start_address(), dmi.get_end_address());
         m_dmi_cache.insert(dmi);
     }
 
     inline void master_socket::unmap_dmi(u64 start, u64 end) {
+        tlb_flush(start, end);
         m_dmi_cache.invalidate(start, end);
+        if (!m_mmio.empty())
+            unmap_mmio(start, end);
     }
 
     inline tlm_response_status master_socket::read(u64 addr, void* data,
@@ -145,13 +241,33 @@ namespace vcml {
     template <typename T>
     inline tlm_response_status master_socket::readw(u64 addr, T& data,
             const sideband& info, unsigned int* nbytes) {
-        return read(addr, &data, sizeof(T), info, nbytes);
+        const unsigned char* ptr = tlb_lookup(addr, sizeof(T), false, info);
+        if (ptr == nullptr)
+            return read(addr, &data, sizeof(T), info, nbytes);
+
+        memcpy(&data, ptr, sizeof(T));
+        if (nbytes != nullptr)
+            *nbytes = sizeof(T);
+        return TLM_OK_RESPONSE;
     }
 
     template <typename T>
     inline tlm_response_status master_socket::writew(u64 addr, const T& data,
             const sideband& info, unsigned int* nbytes) {
-        return write(addr, &data, sizeof(T), info, nbytes);
+        unsigned char* ptr = tlb_lookup(addr, sizeof(T), true, info);
+        if (ptr == nullptr)
+            return write(addr, &data, sizeof(T), info, nbytes);
+
+        memcpy(ptr, &data, sizeof(T));
+        if (nbytes != nullptr)
+            *nbytes = sizeof(T);
+        return TLM_OK_RESPONSE;
+    }
+
+    template <typename T>
+    inline tlm_response_status master_socket::atomicw(vcml_atomic_op op,
+            u64 addr, T& data, T compare, const sideband& info) {
+        return atomic(op, addr, &data, sizeof(T), (u64)compare, info);
     }
 
     template <unsigned int WIDTH>
@@ -196,16 +312,14 @@ namespace vcml {
 
     inline void master_socket::trace_fw(const tlm_generic_payload& tx,
                                         const sc_time& dt) const {
-        if (!m_host->trace_errors && m_host->loglvl >= LOG_TRACE)
+        if (m_host->is_traced(tx, true))
             logger::trace_fw(name(), tx, dt);
     }
 
     inline void master_socket::trace_bw(const tlm_generic_payload& tx,
                                         const sc_time& dt) const {
-        if ((!m_host->trace_errors || failed(tx)) &&
-            m_host->loglvl >= LOG_TRACE) {
+        if (m_host->is_traced(tx, false))
             logger::trace_bw(name(), tx, dt);
-        }
     }
 
     static inline void tx_setup(tlm_generic_payload& tx, tlm_command cmd,
@@ -99,9 +99,53 @@ namespace vcml { namespace generic {
             string peer;
         };
 
+        struct route {
+            range addr;
+            u64 offset;
+            initiator_socket* socket;
+        };
+
+        // mappings are kept sorted by start address and never overlap, so
+        // that the destination of a transaction can be binary searched;
+        // m_bound holds the mappings in bind order as they were requested
+        // and serves lookups once any of them overlap
         vector<mapping> m_mappings;
+        vector<mapping> m_bound;
+        bool            m_overlaps;
         mapping         m_default;
 
+        // m_decode holds the mappings of this bus composed with those of any
+        // generic::bus downstream, so that transactions reach their final
+        // target in a single step; m_routes remembers the index of the route
+        // last used by each IN port, since initiators tend to access the
+        // same target again
+        vector<route>   m_decode;
+        vector<size_t>  m_routes;
+        bool            m_dirty;
+
+        std::map<unsigned int, bus*> m_downstream;
+        vector<bus*>                 m_upstream;
+
+        // DMI regions handed out to each IN port, so that invalidations are
+        // only forwarded to initiators that can actually hold a pointer;
+        // ports bound to an upstream bus that flattened this one never ask
+        // for DMI here and therefore always receive invalidations
+        std::map<unsigned int, dmi_cache> m_dmi_grants;
+        vector<unsigned int>              m_upstream_ports;
+        u64                               m_dmi_filtered;
+
+        void invalidate_dmi_grants(const mapping& m, u64 start, u64 end);
+
+        void invalidate_routes(unsigned int depth = 0);
+        void update_routes();
+
+        void flatten(const range& up, u64 lo, vector<route>& routes,
+                     unsigned int depth);
+        void forward(const mapping& m, const range& up, u64 lo,
+                     vector<route>& routes, unsigned int depth);
+
+        route decode(int port, const range& addr);
+
         target_socket*    create_target_socket(unsigned int idx);
         initiator_socket* create_initiator_socket(unsigned int idx);
 
@@ -125,6 +169,8 @@ namespace vcml { namespace generic {
         void invalidate_direct_mem_ptr(int port, sc_dt::uint64 start,
                                        sc_dt::uint64 end);
 
+        virtual void end_of_elaboration() override;
+
     public:
         bus_ports<target_socket> IN;
         bus_ports<initiator_socket> OUT;
@@ -166,14 +212,14 @@ namespace vcml { namespace generic {
     template <typename T>
     inline void bus::trace_fw(const T& s, const tlm_generic_payload& tx,
                               const sc_time& dt) const {
-        if (loglvl >= LOG_TRACE && !trace_errors)
+        if (is_traced(tx, true))
             logger::trace_fw(s.name(), tx, dt);
     }
 
     template <typename T>
     inline void bus::trace_bw(const T& s, const tlm_generic_payload& tx,
                               const sc_time& dt) const {
-        if (loglvl >= LOG_TRACE && (!trace_errors || failed(tx)))
+        if (is_traced(tx, false))
             logger::trace_bw(s.name(), tx, dt);
     }
 
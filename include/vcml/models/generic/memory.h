@@ -66,6 +66,9 @@ namespace vcml { namespace generic {
                                            const sideband& info) override;
         virtual tlm_response_status write (const range& addr, const void* data,
                                            const sideband& info) override;
+
+        virtual tlm_response_status atomic_transport(const range& addr,
+            void* data, const atomicext& ext, const sideband& info) override;
     };
 
 }}
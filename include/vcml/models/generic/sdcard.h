@@ -200,14 +200,14 @@ namespace vcml { namespace generic {
 
     inline void sdcard::trace_in(sd_command& tx, bool appcmd) const {
         if (logger::would_log(LOG_TRACE) && loglvl >= LOG_TRACE) {
-            logger::log(LOG_TRACE, name(), mkstr(">> %s",
+            logger::log(LOG_TRACE, this, mkstr(">> %s",
                         sd_cmd_str(tx, appcmd).c_str()));
         }
     }
 
     inline void sdcard::trace_out(sd_command& tx, bool appcmd) const {
         if (logger::would_log(LOG_TRACE) && loglvl >= LOG_TRACE) {
-            logger::log(LOG_TRACE, name(), mkstr("<< %s",
+            logger::log(LOG_TRACE, this, mkstr("<< %s",
                         sd_cmd_str(tx, appcmd).c_str()));
         }
     }
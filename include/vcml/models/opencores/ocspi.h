@@ -81,12 +81,12 @@ namespace vcml { namespace opencores {
 
     inline void ocspi::trace_in(u8 val) const {
         if (logger::would_log(LOG_TRACE) && loglvl >= LOG_TRACE)
-            logger::log(LOG_TRACE, name(), mkstr("<< 0x%02x", val));
+            logger::log(LOG_TRACE, this, mkstr("<< 0x%02x", val));
     }
 
     inline void ocspi::trace_out(u8 val) const {
         if (logger::would_log(LOG_TRACE) && loglvl >= LOG_TRACE)
-            logger::log(LOG_TRACE, name(), mkstr(">> 0x%02x", val));
+            logger::log(LOG_TRACE, this, mkstr(">> 0x%02x", val));
     }
 
 }}
@@ -24,6 +24,8 @@
 #include "vcml/common/report.h"
 
 #include "vcml/logging/logger.h"
+#include "vcml/logging/log_limiter.h"
+#include "vcml/logging/trace_predicate.h"
 #include "vcml/properties/property.h"
 
 #include "vcml/command.h"
@@ -34,16 +36,22 @@ namespace vcml {
     {
     private:
         std::map<string, command_base*> m_commands;
+        mutable u64 m_trace_version;
+        mutable trace_predicate m_trace_predicate;
+        mutable log_limiter m_log_limiter;
 
         bool cmd_clist(const vector<string>& args, ostream& os);
         bool cmd_cinfo(const vector<string>& args, ostream& os);
         bool cmd_abort(const vector<string>& args, ostream& os);
 
         log_level default_log_level() const;
+        void update_trace_predicate() const;
 
     public:
         property<bool> trace_errors;
+        property<string> trace_filter;
         property<log_level> loglvl;
+        property<unsigned int> log_rate;
 
         module() = delete;
         module(const module&) = delete;
@@ -68,13 +76,20 @@ namespace vcml {
         command_base* get_command(const string& name);
         vector<command_base*> get_commands() const;
 
+        void set_trace_filter(const string& spec);
+        bool is_traced(const tlm_generic_payload& tx, bool forward) const;
+
+        bool check_rate(log_level lvl, const char* format) const;
+
 #define VCML_DEFINE_LOG(log_name, level)                      \
         inline void log_name(const char* format, ...) const { \
             if (!logger::would_log(level) || level > loglvl)  \
                 return;                                       \
+            if (log_rate > 0 && !check_rate(level, format))   \
+                return;                                       \
             va_list args;                                     \
             va_start(args, format);                           \
-            logger::log(level, name(), vmkstr(format, args)); \
+            logger::log(level, this, vmkstr(format, args));   \
             va_end(args);                                     \
         }
 
@@ -99,6 +114,21 @@ namespace vcml {
         VCML_ERROR_ON(top != this, "broken hierarchy");
     }
 
+    inline bool module::is_traced(const tlm_generic_payload& tx,
+                                  bool forward) const {
+        if (loglvl.get() < LOG_TRACE)
+            return false;
+        if (trace_errors && (forward || !failed(tx)))
+            return false;
+        if (trace_filter.version() != m_trace_version)
+            update_trace_predicate();
+        return m_trace_predicate.matches(tx, forward);
+    }
+
+    inline bool module::check_rate(log_level lvl, const char* format) const {
+        return m_log_limiter.allow(lvl, format, log_rate);
+    }
+
     template <class T>
     void module::register_command(const string& cmdnm, unsigned int argc,
                 T* host, bool (T::*func)(const vector<string>&, ostream&),
@@ -29,6 +29,7 @@
 
 #include "vcml/range.h"
 #include "vcml/sbi.h"
+#include "vcml/atomic.h"
 #include "vcml/dmi_cache.h"
 #include "vcml/component.h"
 #include "vcml/register.h"
@@ -45,8 +46,21 @@ namespace vcml {
         vector<reg_base*> m_registers;
         vector<backend*> m_backends;
 
+        // registers are only sorted and checked for overlaps once they are
+        // needed, so that adding many registers during construction is cheap
+        bool m_registers_sorted;
+
+        void sort_registers();
+
+        // limits an access so that it stays within a single register, or
+        // within a single gap between registers
+        unsigned int clip_to_register(u64 addr, unsigned int size);
+
         bool cmd_mmap(const vector<string>& args, ostream& os);
 
+    protected:
+        virtual void end_of_elaboration() override;
+
     public:
         property<unsigned int> read_latency;
         property<unsigned int> write_latency;
@@ -105,6 +119,11 @@ namespace vcml {
         virtual tlm_response_status write (const range& addr, const void* data,
                                            const sideband& info);
 
+        virtual tlm_response_status atomic_transport(const range& addr,
+                                                     void* data,
+                                                     const atomicext& ext,
+                                                     const sideband& info);
+
         virtual void handle_clock_update(clock_t oldclk,
                                          clock_t newclk) override;
     };
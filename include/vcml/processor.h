@@ -22,6 +22,7 @@
 #include "vcml/common/types.h"
 #include "vcml/common/report.h"
 #include "vcml/common/bitops.h"
+#include "vcml/common/thctl.h"
 
 #include "vcml/logging/logger.h"
 #include "vcml/backends/backend.h"
@@ -45,6 +46,9 @@ namespace vcml {
         sc_time      irq_last;
         sc_time      irq_uptime;
         sc_time      irq_longest;
+        bool         irq_pending;  // asserted, but not yet seen by simulate
+        unsigned int irq_serviced;
+        sc_time      irq_latency;  // total time from assertion to service
     };
 
     struct cpureg {
@@ -60,10 +64,19 @@ namespace vcml {
     private:
         double m_run_time;
         u64    m_cycle_count;
+        u64    m_cycles_skipped;
         elf*   m_symbols;
 
         debugging::gdbserver* m_gdb;
 
+        thctl_worker* m_worker;
+        sc_event      m_worker_ev;
+
+        bool     m_idle;
+        bool     m_irq_pending;
+        u64      m_irq_gen;
+        sc_event m_irq_ev;
+
         std::map<unsigned int, irq_stats> m_irq_stats;
 
         struct cpureg_info: public cpureg {
@@ -97,6 +110,13 @@ namespace vcml {
         void set_cpureg_internal(const cpureg_info& reg, u64 val);
 
         void processor_thread();
+        void simulate_parallel(unsigned int cycles);
+        void wait_idle();
+        void service_irqs();
+
+        sc_time quantum_horizon(const sc_time& quantum) const;
+
+        static void parallel_dispatcher();
 
         void irq_handler(unsigned int irq);
 
@@ -108,6 +128,9 @@ namespace vcml {
         property<bool> gdb_sync;
         property<bool> gdb_echo;
 
+        property<bool> parallel;
+        property<sc_time> horizon;
+
         in_port_list<bool> IRQ;
 
         master_socket INSN;
@@ -138,6 +161,8 @@ namespace vcml {
         double get_run_time() const { return m_run_time; }
         double get_cps()      const { return cycle_count() / m_run_time; }
 
+        u64 get_cycles_skipped() const { return m_cycles_skipped; }
+
         virtual void reset() override;
 
         bool get_irq_stats(unsigned int irq, irq_stats& stats) const;
@@ -173,6 +198,12 @@ namespace vcml {
         void log_bus_error(const master_socket& socket, vcml_access accss,
                            tlm_response_status rs, u64 addr, u64 size);
 
+        // simulate may call wait_for_interrupt once the core has nothing to
+        // do until the next interrupt, processor_thread then stops calling
+        // simulate until an IRQ changes or the next event elsewhere is due;
+        // the cycles spent idle are counted in get_cycles_skipped
+        void wait_for_interrupt() { m_idle = true; }
+
         virtual void interrupt(unsigned int irq, bool set);
         virtual void simulate(unsigned int cycles) = 0;
         virtual void update_local_time(sc_time& local_time) override;
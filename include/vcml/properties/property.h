@@ -142,6 +142,7 @@ namespace vcml {
 
         for (unsigned int i = 0; i < min(N, size); i++)
             m_value[i] = from_string<T>(trim(args[i]));
+        bump_version();
     }
 
     template <typename T, const unsigned int N>
@@ -186,6 +187,7 @@ namespace vcml {
         for (unsigned int i = 0; i < N; i++)
             m_value[i] = val;
         m_inited = true;
+        bump_version();
     }
 
     template <typename T, const unsigned int N>
@@ -193,6 +195,7 @@ namespace vcml {
         for (unsigned int i = 0; i < N; i++)
             m_value[i] = val[i];
         m_inited = true;
+        bump_version();
     }
 
     template <typename T, const unsigned int N>
@@ -200,6 +203,7 @@ namespace vcml {
         VCML_ERROR_ON(idx >= N, "index %d out of bounds", idx);
         m_value[idx] = val;
         m_inited = true;
+        bump_version();
     }
 
     template <typename T, const unsigned int N>
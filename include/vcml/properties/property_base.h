@@ -31,6 +31,10 @@ namespace vcml {
     private:
         string     m_base;
         sc_module* m_parent;
+        u64        m_version;
+
+    protected:
+        void bump_version() { m_version++; }
 
     public:
         property_base(const char* name, sc_module* parent = nullptr);
@@ -44,6 +48,10 @@ namespace vcml {
         const char* basename()   const { return m_base.c_str(); }
         sc_module*  get_module() const { return m_parent; }
 
+        // increments whenever the value is set or parsed, but not for writes
+        // through references returned by get() or operator []
+        u64 version() const { return m_version; }
+
         virtual const char* str() const = 0;
         virtual void str(const string& s) = 0;
 
@@ -84,6 +84,17 @@ namespace vcml {
 
         virtual void do_read(const range& addr, void* ptr) = 0;
         virtual void do_write(const range& addr, const void* ptr) = 0;
+
+    protected:
+        bool needs_swap() const;
+
+        // generic access path: converts the whole access into host byte
+        // order, calls do_read or do_write and converts the data back
+        void do_generic_access(const range& addr, unsigned char* ptr,
+                               bool is_read, bool swap);
+
+        virtual void do_access(const range& addr, unsigned char* ptr,
+                               bool is_read);
     };
 
     inline bool reg_base::is_read_only() const {
@@ -94,7 +105,13 @@ namespace vcml {
         return m_access == VCML_ACCESS_WRITE;
     }
 
-    template <class HOST, typename DATA, const unsigned int N = 1>
+    // number of banks, i.e. CPUs, of banked registers unless specified
+    const unsigned int REG_DEFAULT_BANKS = 32;
+
+    // E fixes the byte order of the register at compile time; by default
+    // (VCML_ENDIAN_UNKNOWN) the endianess of the host peripheral is used
+    template <class HOST, typename DATA, const unsigned int N = 1,
+              const vcml_endian E = VCML_ENDIAN_UNKNOWN>
     class reg: public reg_base,
                public property<DATA, N>
     {
@@ -102,9 +119,23 @@ namespace vcml {
         HOST* m_host;
         bool m_banked;
         DATA m_init[N];
-        std::map<int, DATA*> m_banks;
 
-        void init_bank(int bank);
+        // banks are stored back to back, indexed by bank * N + idx; the
+        // slots of bank 0 stay unused, since it lives in the property itself;
+        // the array is sized once by set_banked and never moves afterwards,
+        // banks beyond it are allocated on first write in m_extra_banks
+        unsigned int m_nbanks;
+        vector<DATA> m_banks;
+        std::map<int, vector<DATA>> m_extra_banks;
+
+        DATA& extra_bank(int bank, unsigned int idx);
+
+        DATA fetch(unsigned int idx);
+        void store(unsigned int idx, DATA val);
+
+    protected:
+        virtual void do_access(const range& addr, unsigned char* ptr,
+                               bool is_read) override;
 
     public:
         typedef DATA (HOST::*readfunc)  (void);
@@ -122,7 +153,9 @@ namespace vcml {
         tagged_writefunc tagged_write;
 
         bool is_banked() const { return m_banked; }
-        void set_banked(bool set = true) { m_banked = set; }
+        void set_banked(bool set = true,
+                        unsigned int nbanks = REG_DEFAULT_BANKS);
+        unsigned int num_banks() const { return m_nbanks; }
 
         const DATA& bank(int bank) const;
         DATA& bank(int bank);
@@ -152,14 +185,14 @@ namespace vcml {
         const DATA& operator [] (unsigned int idx) const;
         DATA& operator [] (unsigned int idx);
 
-        template <typename T> reg<HOST, DATA, N>& operator =  (T value);
-        template <typename T> reg<HOST, DATA, N>& operator |= (T value);
-        template <typename T> reg<HOST, DATA, N>& operator &= (T value);
-        template <typename T> reg<HOST, DATA, N>& operator ^= (T value);
-        template <typename T> reg<HOST, DATA, N>& operator += (T value);
-        template <typename T> reg<HOST, DATA, N>& operator -= (T value);
-        template <typename T> reg<HOST, DATA, N>& operator *= (T value);
-        template <typename T> reg<HOST, DATA, N>& operator /= (T value);
+        template <typename T> reg<HOST, DATA, N, E>& operator =  (T value);
+        template <typename T> reg<HOST, DATA, N, E>& operator |= (T value);
+        template <typename T> reg<HOST, DATA, N, E>& operator &= (T value);
+        template <typename T> reg<HOST, DATA, N, E>& operator ^= (T value);
+        template <typename T> reg<HOST, DATA, N, E>& operator += (T value);
+        template <typename T> reg<HOST, DATA, N, E>& operator -= (T value);
+        template <typename T> reg<HOST, DATA, N, E>& operator *= (T value);
+        template <typename T> reg<HOST, DATA, N, E>& operator /= (T value);
 
         template <typename T> bool operator == (T other) const;
         template <typename T> bool operator != (T other) const;
@@ -172,66 +205,96 @@ namespace vcml {
         template <typename F, typename T> void set_bitfield(F field, T val);
     };
 
-    template <class HOST, typename DATA, const unsigned int N>
-    void reg<HOST, DATA, N>::init_bank(int bank) {
-        VCML_ERROR_ON(!m_banked, "cannot create banks in register %s", name());
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    void reg<HOST, DATA, N, E>::set_banked(bool set, unsigned int nbanks) {
+        VCML_ERROR_ON(sc_core::sc_is_running(), "cannot change banks of "
+                      "register %s during simulation", name());
+        VCML_ERROR_ON(set && nbanks == 0, "register %s needs at least one "
+                      "bank", name());
 
-        if (bank == 0 || stl_contains(m_banks, bank))
-            return;
+        m_banked = set;
+        m_nbanks = set ? nbanks : 0;
+        m_banks.assign(m_nbanks * N, DATA());
+        m_extra_banks.clear();
 
-        m_banks[bank] = new DATA[N];
-        for (unsigned int i = 0; i < N; i++)
-            m_banks[bank][i] = m_init[i];
+        for (unsigned int bk = 1; bk < m_nbanks; bk++)
+            for (unsigned int i = 0; i < N; i++)
+                m_banks[bk * N + i] = m_init[i];
+    }
+
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    DATA& reg<HOST, DATA, N, E>::extra_bank(int bk, unsigned int idx) {
+        auto it = m_extra_banks.find(bk);
+        if (it == m_extra_banks.end()) {
+            vector<DATA> init(m_init, m_init + N);
+            it = m_extra_banks.emplace(bk, std::move(init)).first;
+        }
+
+        return it->second[idx];
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    const DATA& reg<HOST, DATA, N>::bank(int bk) const {
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    const DATA& reg<HOST, DATA, N, E>::bank(int bk) const {
         return bank(bk, 0);
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    DATA& reg<HOST, DATA, N>::bank(int bk) {
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    DATA& reg<HOST, DATA, N, E>::bank(int bk) {
         return bank(bk, 0);
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    const DATA& reg<HOST, DATA, N>::bank(int bk,  unsigned int idx) const {
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    const DATA& reg<HOST, DATA, N, E>::bank(int bk,  unsigned int idx) const {
         VCML_ERROR_ON(idx >= N, "index %d out of bounds", idx);
         if (bk == 0 || !m_banked)
             return property<DATA, N>::get(idx);
-        if (!stl_contains(m_banks, bk))
+        if (bk > 0 && (unsigned int)bk < m_nbanks)
+            return m_banks[bk * N + idx];
+        auto it = m_extra_banks.find(bk);
+        if (it == m_extra_banks.end())
             return property<DATA, N>::get_default();
-        return m_banks.at(bk)[idx];
+        return it->second[idx];
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    DATA& reg<HOST, DATA, N>::bank(int bk, unsigned int idx) {
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    DATA& reg<HOST, DATA, N, E>::bank(int bk, unsigned int idx) {
         VCML_ERROR_ON(idx >= N, "index %d out of bounds", idx);
         if (bk == 0 || !m_banked)
             return property<DATA, N>::get(idx);
-        if (!stl_contains(m_banks, bk))
-            init_bank(bk);
-        return m_banks[bk][idx];
+        if (bk > 0 && (unsigned int)bk < m_nbanks)
+            return m_banks[bk * N + idx];
+        return extra_bank(bk, idx);
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    const DATA& reg<HOST, DATA, N>::current_bank(unsigned int idx) const {
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    const DATA& reg<HOST, DATA, N, E>::current_bank(unsigned int idx) const {
         return bank(m_host->current_cpu(), idx);
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    DATA& reg<HOST, DATA, N>::current_bank(unsigned int idx) {
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    DATA& reg<HOST, DATA, N, E>::current_bank(unsigned int idx) {
         return bank(m_host->current_cpu(), idx);
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    reg<HOST, DATA, N>::reg(const char* n, u64 addr, DATA def, HOST* h):
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    reg<HOST, DATA, N, E>::reg(const char* n, u64 addr, DATA def, HOST* h):
         reg_base(n, addr, N * sizeof(DATA), h),
         property<DATA, N>(n, def, h),
         m_host(h),
         m_banked(false),
         m_init(),
+        m_nbanks(0),
         m_banks(),
+        m_extra_banks(),
         read(nullptr),
         write(nullptr),
         tag(0),
@@ -245,25 +308,85 @@ namespace vcml {
         VCML_ERROR_ON(!m_host, "invalid host specified for register %s", n);
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    reg<HOST, DATA, N>::~reg() {
-        for (auto bank : m_banks)
-            delete [] bank.second;
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    reg<HOST, DATA, N, E>::~reg() {
+        // nothing to do
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    void reg<HOST, DATA, N>::reset() {
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    void reg<HOST, DATA, N, E>::reset() {
         for (unsigned int i = 0; i < N; i++)
             property<DATA, N>::set(m_init[i], i);
 
-        for (auto bank : m_banks) {
+        for (unsigned int bk = 1; bk < m_nbanks; bk++)
+            for (unsigned int i = 0; i < N; i++)
+                m_banks[bk * N + i] = m_init[i];
+
+        for (auto& bank : m_extra_banks)
             for (unsigned int i = 0; i < N; i++)
-                m_banks[bank.first][i] = m_init[i];
+                bank.second[i] = m_init[i];
+    }
+
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    DATA reg<HOST, DATA, N, E>::fetch(unsigned int idx) {
+        DATA val = current_bank(idx);
+
+        if (tagged_read != nullptr)
+            val = (m_host->*tagged_read)(N > 1 ? idx : tag);
+        else if (read != nullptr)
+            val = (m_host->*read)();
+
+        current_bank(idx) = val;
+        return val;
+    }
+
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    void reg<HOST, DATA, N, E>::store(unsigned int idx, DATA val) {
+        if (tagged_write != nullptr)
+            val = (m_host->*tagged_write)(val, N > 1 ? idx : tag);
+        else if (write != nullptr)
+            val = (m_host->*write)(val);
+
+        current_bank(idx) = val;
+    }
+
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    void reg<HOST, DATA, N, E>::do_access(const range& addr,
+                                          unsigned char* ptr, bool is_read) {
+        const bool swap = E == VCML_ENDIAN_UNKNOWN ? needs_swap()
+                                                   : E != host_endian();
+
+        // partial and multi-element accesses take the generic route
+        u64 off = addr.start - get_address();
+        if (addr.length() != sizeof(DATA) || off % sizeof(DATA)) {
+            do_generic_access(addr, ptr, is_read, swap);
+            return;
+        }
+
+        unsigned int idx = off / sizeof(DATA);
+        DATA val;
+
+        if (is_read) {
+            val = fetch(idx);
+            if (swap)
+                val = bswap(val);
+            memcpy(ptr, &val, sizeof(val));
+        } else {
+            memcpy(&val, ptr, sizeof(val));
+            if (swap)
+                val = bswap(val);
+            store(idx, val);
         }
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    void reg<HOST, DATA, N>::do_read(const range& txaddr,  void* ptr) {
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    void reg<HOST, DATA, N, E>::do_read(const range& txaddr, void* ptr) {
         range addr(txaddr);
         unsigned char* dest = (unsigned char*)ptr;
 
@@ -272,14 +395,7 @@ namespace vcml {
             u64 off  = (addr.start - get_address()) % sizeof(DATA);
             u64 size = min(addr.length(), (u64)sizeof(DATA));
 
-            DATA val = current_bank(idx);
-
-            if (tagged_read != nullptr)
-                val = (m_host->*tagged_read)(N > 1 ? idx : tag);
-            else if (read != nullptr)
-                val = (m_host->*read)();
-
-            current_bank(idx) = val;
+            DATA val = fetch(idx);
 
             unsigned char* ptr = (unsigned char*)&val + off;
             memcpy(dest, ptr, size);
@@ -289,8 +405,10 @@ namespace vcml {
         }
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    void reg<HOST, DATA, N>::do_write(const range& txaddr, const void* data) {
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    void reg<HOST, DATA, N, E>::do_write(const range& txaddr,
+                                         const void* data) {
         range addr(txaddr);
         const unsigned char* src = (const unsigned char*)data;
 
@@ -304,151 +422,165 @@ namespace vcml {
             unsigned char* ptr = (unsigned char*)&val + off;
             memcpy(ptr, src, size);
 
-            if (tagged_write != nullptr)
-                val = (m_host->*tagged_write)(val, N > 1 ? idx : tag);
-            else if (write != nullptr)
-                val = (m_host->*write)(val);
-
-            current_bank(idx) = val;
+            store(idx, val);
 
             addr.start += size;
             src += size;
         }
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    reg<HOST, DATA, N>::operator DATA() const {
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    reg<HOST, DATA, N, E>::operator DATA() const {
         return current_bank();
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    const DATA& reg<HOST, DATA, N>::operator [] (unsigned int idx) const {
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    const DATA& reg<HOST, DATA, N, E>::operator [] (unsigned int idx) const {
         return current_bank(idx);
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
-    DATA& reg<HOST, DATA, N>::operator [] (unsigned int idx) {
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
+    DATA& reg<HOST, DATA, N, E>::operator [] (unsigned int idx) {
         return current_bank(idx);
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    reg<HOST, DATA, N>& reg<HOST, DATA, N>::operator = (T value) {
+    reg<HOST, DATA, N, E>& reg<HOST, DATA, N, E>::operator = (T value) {
         for (unsigned int i = 0; i < N; i++)
             current_bank(i) = value;
         return *this;
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    reg<HOST, DATA, N>& reg<HOST, DATA, N>::operator |= (T value) {
+    reg<HOST, DATA, N, E>& reg<HOST, DATA, N, E>::operator |= (T value) {
         for (unsigned int i = 0; i < N; i++)
             current_bank(i) |= value;
         return *this;
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    reg<HOST, DATA, N>& reg<HOST, DATA, N>::operator &= (T value) {
+    reg<HOST, DATA, N, E>& reg<HOST, DATA, N, E>::operator &= (T value) {
         for (unsigned int i = 0; i < N; i++)
             current_bank(i) &= value;
         return *this;
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    reg<HOST, DATA, N>& reg<HOST, DATA, N>::operator ^= (T value) {
+    reg<HOST, DATA, N, E>& reg<HOST, DATA, N, E>::operator ^= (T value) {
         for (unsigned int i = 0; i < N; i++)
             current_bank(i) ^= value;
         return *this;
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    reg<HOST, DATA, N>& reg<HOST, DATA, N>::operator += (T value) {
+    reg<HOST, DATA, N, E>& reg<HOST, DATA, N, E>::operator += (T value) {
         for (unsigned int i = 0; i < N; i++)
             current_bank(i) += value;
         return *this;
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    reg<HOST, DATA, N>& reg<HOST, DATA, N>::operator -= (T value) {
+    reg<HOST, DATA, N, E>& reg<HOST, DATA, N, E>::operator -= (T value) {
         for (unsigned int i = 0; i < N; i++)
             current_bank(i) -= value;
         return *this;
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    reg<HOST, DATA, N>& reg<HOST, DATA, N>::operator *= (T value) {
+    reg<HOST, DATA, N, E>& reg<HOST, DATA, N, E>::operator *= (T value) {
         for (unsigned int i = 0; i < N; i++)
             current_bank(i) *= value;
         return *this;
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    reg<HOST, DATA, N>& reg<HOST, DATA, N>::operator /= (T value) {
+    reg<HOST, DATA, N, E>& reg<HOST, DATA, N, E>::operator /= (T value) {
         for (unsigned int i = 0; i < N; i++)
             current_bank(i) /= value;
         return *this;
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    inline bool reg<HOST, DATA, N>::operator == (T other) const {
+    inline bool reg<HOST, DATA, N, E>::operator == (T other) const {
         for (unsigned int i = 0; i < N; i++)
             if (current_bank(i) != other)
                 return false;
         return true;
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    inline bool reg<HOST, DATA, N>::operator < (T other) const {
+    inline bool reg<HOST, DATA, N, E>::operator < (T other) const {
         for (unsigned int i = 0; i < N; i++)
             if (current_bank(i) >= other)
                 return false;
         return true;
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    inline bool reg<HOST, DATA, N>::operator > (T other) const {
+    inline bool reg<HOST, DATA, N, E>::operator > (T other) const {
         for (unsigned int i = 0; i < N; i++)
             if (current_bank(i) <= other)
                 return false;
         return true;
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    inline bool reg<HOST, DATA, N>::operator != (T other) const {
+    inline bool reg<HOST, DATA, N, E>::operator != (T other) const {
         return !operator == (other);
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    inline bool reg<HOST, DATA, N>::operator <= (T other) const {
+    inline bool reg<HOST, DATA, N, E>::operator <= (T other) const {
         return !operator > (other);
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename T>
-    inline bool reg<HOST, DATA, N>::operator >= (T other) const {
+    inline bool reg<HOST, DATA, N, E>::operator >= (T other) const {
         return !operator < (other);
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename F>
-    inline DATA reg<HOST, DATA, N>::get_bitfield(F field) {
+    inline DATA reg<HOST, DATA, N, E>::get_bitfield(F field) {
         return get_bitfield(field, current_bank());
     }
 
-    template <class HOST, typename DATA, const unsigned int N>
+    template <class HOST, typename DATA, const unsigned int N,
+              const vcml_endian E>
     template <typename F, typename T>
-    inline void reg<HOST, DATA, N>::set_bitfield(F field, T val) {
+    inline void reg<HOST, DATA, N, E>::set_bitfield(F field, T val) {
         for (unsigned int i = 0; i < N; i++)
             set_bitfield(field, current_bank(i));
     }
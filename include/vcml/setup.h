@@ -26,6 +26,7 @@
 #include "vcml/logging/log_term.h"
 #include "vcml/logging/log_file.h"
 #include "vcml/logging/log_stream.h"
+#include "vcml/logging/trace_file.h"
 
 #include "vcml/properties/property.h"
 #include "vcml/properties/property_provider.h"
@@ -46,8 +47,10 @@ namespace vcml {
         vector<string>  m_log_files;
         vector<string>  m_trace_files;
         vector<string>  m_config_files;
+        string          m_trace_binary;
 
         vector<logger*> m_loggers;
+        trace_file*     m_tracer;
         vector<property_provider*> m_providers;
 
         bool parse_command_line(int argc, char** argv);
@@ -66,6 +69,7 @@ namespace vcml {
         const vector<string>& log_files() const { return m_log_files; }
         const vector<string>& trace_files() const { return m_trace_files; }
         const vector<string>& config_files() const { return m_config_files; }
+        const string& trace_binary() const { return m_trace_binary; }
 
         unsigned int argc() const { return m_args.size(); }
         const vector<string>& argv() const { return m_args; }
@@ -32,8 +32,29 @@
 
 namespace vcml {
 
+    // Attached by initiators to DMI requests: targets that cannot grant DMI
+    // but allow MMIO-DMI hand out their socket instead, so that subsequent
+    // accesses can be sent there directly without passing interconnects.
+    class mmioext: public tlm_extension<mmioext>
+    {
+    public:
+        slave_socket* socket;
+        u64 addr; // request address as seen by the target
+
+        mmioext(): socket(nullptr), addr(0) {}
+
+        virtual tlm_extension_base* clone() const override;
+        virtual void copy_from(const tlm_extension_base& ext) override;
+    };
+
+    inline const mmioext* tx_get_mmio(const tlm_generic_payload& tx) {
+        const mmioext* ext = tx.get_extension<mmioext>();
+        return ext != nullptr && ext->socket != nullptr ? ext : nullptr;
+    }
+
     class slave_socket: public simple_target_socket<slave_socket, 64>
     {
+        friend class master_socket;
     private:
         int        m_curr;
         int        m_next;
@@ -42,6 +63,9 @@ namespace vcml {
         exmon      m_exmon;
         sc_module* m_adapter;
         component* m_host;
+        bool       m_mmio;
+
+        bool mmio_allowed(const tlm_generic_payload& tx) const;
 
         void b_transport(tlm_generic_payload& tx, sc_time& dt);
         unsigned int transport_dbg(tlm_generic_payload& tx);
@@ -72,6 +96,11 @@ namespace vcml {
         void trace_bw(const tlm_generic_payload& tx, const sc_time& dt) const;
     };
 
+    inline bool slave_socket::mmio_allowed(
+            const tlm_generic_payload& tx) const {
+        return m_host->mmio_dmi && tx.get_extension<mmioext>() != nullptr;
+    }
+
     inline void slave_socket::map_dmi(const tlm_dmi& dmi) {
         m_dmi_cache.insert(dmi);
     }
@@ -118,16 +147,14 @@ namespace vcml {
 
     inline void slave_socket::trace_fw(const tlm_generic_payload& tx,
                                        const sc_time& dt) const {
-        if (!m_host->trace_errors && m_host->loglvl >= LOG_TRACE)
+        if (m_host->is_traced(tx, true))
             logger::trace_fw(name(), tx, dt);
     }
 
     inline void slave_socket::trace_bw(const tlm_generic_payload& tx,
                                        const sc_time& dt) const {
-        if ((!m_host->trace_errors || failed(tx)) &&
-            m_host->loglvl >= LOG_TRACE) {
+        if (m_host->is_traced(tx, false))
             logger::trace_bw(name(), tx, dt);
-        }
     }
 
 }
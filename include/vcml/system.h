@@ -28,6 +28,16 @@ namespace vcml {
 
     class system: public module
     {
+    private:
+        sc_time m_quantum;
+        double  m_run_time;
+        double  m_realtime;
+        sc_time m_irq_latency;
+
+        void sample_stats(double& run_time, sc_time& irq_latency) const;
+        void tune_quantum();
+        void quantum_tuner();
+
     public:
         property<string>  name;
         property<string>  desc;
@@ -40,6 +50,11 @@ namespace vcml {
         property<sc_time> quantum;
         property<sc_time> duration;
 
+        property<bool>    quantum_auto;
+        property<sc_time> quantum_min;
+        property<sc_time> quantum_max;
+        property<sc_time> quantum_interval;
+
         system() = delete;
         system(const system&) = delete;
         explicit system(const sc_module_name& name);
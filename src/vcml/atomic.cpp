@@ -0,0 +1,146 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <type_traits>
+
+#include "vcml/atomic.h"
+
+namespace vcml {
+
+    const char* atomic_op_to_str(vcml_atomic_op op) {
+        switch (op) {
+        case VCML_ATOMIC_NONE: return "none";
+        case VCML_ATOMIC_SWAP: return "swap";
+        case VCML_ATOMIC_CAS: return "cas";
+        case VCML_ATOMIC_ADD: return "add";
+        case VCML_ATOMIC_AND: return "and";
+        case VCML_ATOMIC_OR: return "or";
+        case VCML_ATOMIC_XOR: return "xor";
+        case VCML_ATOMIC_MIN: return "min";
+        case VCML_ATOMIC_MAX: return "max";
+        case VCML_ATOMIC_MINU: return "minu";
+        case VCML_ATOMIC_MAXU: return "maxu";
+        default:
+            return "unknown";
+        }
+    }
+
+    tlm_extension_base* atomicext::clone() const {
+        return new atomicext(*this);
+    }
+
+    void atomicext::copy_from(const tlm_extension_base& ext) {
+        VCML_ERROR_ON(typeid(this) != typeid(ext), "cannot copy extension");
+        const atomicext& other = (const atomicext&)ext;
+        op = other.op;
+        compare = other.compare;
+        ack = other.ack;
+    }
+
+    template <typename T, typename CMP>
+    static T atomic_update(T* mem, T val, CMP pick) {
+        T old = __atomic_load_n(mem, __ATOMIC_SEQ_CST);
+        while (!__atomic_compare_exchange_n(mem, &old, pick(old, val), false,
+                                            __ATOMIC_SEQ_CST,
+                                            __ATOMIC_SEQ_CST)) {
+            /* old has been updated, try again */
+        }
+
+        return old;
+    }
+
+    template <typename T>
+    static void atomic_execute(vcml_atomic_op op, T* mem, void* data,
+                               u64 compare) {
+        typedef typename std::make_signed<T>::type S;
+
+        T val, old = 0;
+        memcpy(&val, data, sizeof(val));
+
+        switch (op) {
+        case VCML_ATOMIC_SWAP:
+            old = __atomic_exchange_n(mem, val, __ATOMIC_SEQ_CST);
+            break;
+
+        case VCML_ATOMIC_CAS:
+            // old receives the current contents if the exchange fails
+            old = (T)compare;
+            __atomic_compare_exchange_n(mem, &old, val, false,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+            break;
+
+        case VCML_ATOMIC_ADD:
+            old = __atomic_fetch_add(mem, val, __ATOMIC_SEQ_CST);
+            break;
+
+        case VCML_ATOMIC_AND:
+            old = __atomic_fetch_and(mem, val, __ATOMIC_SEQ_CST);
+            break;
+
+        case VCML_ATOMIC_OR:
+            old = __atomic_fetch_or(mem, val, __ATOMIC_SEQ_CST);
+            break;
+
+        case VCML_ATOMIC_XOR:
+            old = __atomic_fetch_xor(mem, val, __ATOMIC_SEQ_CST);
+            break;
+
+        case VCML_ATOMIC_MIN:
+            old = atomic_update(mem, val, [](T a, T b) -> T {
+                return (S)a < (S)b ? a : b;
+            });
+            break;
+
+        case VCML_ATOMIC_MAX:
+            old = atomic_update(mem, val, [](T a, T b) -> T {
+                return (S)a > (S)b ? a : b;
+            });
+            break;
+
+        case VCML_ATOMIC_MINU:
+            old = atomic_update(mem, val, [](T a, T b) -> T {
+                return a < b ? a : b;
+            });
+            break;
+
+        case VCML_ATOMIC_MAXU:
+            old = atomic_update(mem, val, [](T a, T b) -> T {
+                return a > b ? a : b;
+            });
+            break;
+
+        default:
+            VCML_ERROR("invalid atomic operation %d", (int)op);
+        }
+
+        memcpy(data, &old, sizeof(old));
+    }
+
+    void atomic_execute(vcml_atomic_op op, void* mem, void* data,
+                        unsigned int size, u64 compare) {
+        switch (size) {
+        case 1: atomic_execute(op, (u8*)mem, data, compare); break;
+        case 2: atomic_execute(op, (u16*)mem, data, compare); break;
+        case 4: atomic_execute(op, (u32*)mem, data, compare); break;
+        case 8: atomic_execute(op, (u64*)mem, data, compare); break;
+        default:
+            VCML_ERROR("invalid atomic access size %u", size);
+        }
+    }
+
+}
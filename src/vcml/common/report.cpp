@@ -25,6 +25,8 @@
 #include "vcml/common/thctl.h"
 #include "vcml/common/systemc.h"
 
+#include "vcml/logging/log_writer.h"
+
 namespace vcml {
 
     unsigned int report::max_backtrace_length = 16;
@@ -51,6 +53,8 @@ namespace vcml {
     static struct sigaction oldact;
 
     static void handle_segfault(int sig, siginfo_t* info, void* context) {
+        log_writer::flush_all();
+
         fprintf(stderr, "Backtrace\n");
         auto symbols = vcml::backtrace(report::max_backtrace_length, 2);
         for (unsigned int i = symbols.size() - 1; i < symbols.size(); i--)
@@ -77,6 +77,165 @@ namespace vcml {
         VCML_ERROR_ON(res != 0, "pthread_cond_signal: %s", strerror(res));
     }
 
+    static thread_local thctl_worker* g_thctl_worker = nullptr;
+
+    struct thctl_worker_exit {
+        /* nothing to do */
+    };
+
+    thctl_worker* thctl_current_worker() {
+        return g_thctl_worker;
+    }
+
+    bool thctl_is_worker_thread() {
+        return g_thctl_worker != nullptr;
+    }
+
+    void* thctl_worker::thread_func(void* arg) {
+        thctl_worker* worker = (thctl_worker*)arg;
+        g_thctl_worker = worker;
+        worker->work();
+        return nullptr;
+    }
+
+    void thctl_worker::wait_state(worker_state state) {
+        while (m_state != state && m_state != WORKER_EXIT)
+            pthread_cond_wait(&m_notify, &m_mutex);
+    }
+
+    void thctl_worker::set_state(worker_state state) {
+        m_state = state;
+        pthread_cond_broadcast(&m_notify);
+    }
+
+    void thctl_worker::work() {
+        pthread_mutex_lock(&m_mutex);
+        while (true) {
+            wait_state(WORKER_RUNNING);
+            if (m_state == WORKER_EXIT)
+                break;
+
+            pthread_mutex_unlock(&m_mutex);
+
+            try {
+                m_job();
+            } catch (thctl_worker_exit&) {
+                pthread_mutex_lock(&m_mutex);
+                break;
+            } catch (...) {
+                m_error = std::current_exception();
+            }
+
+            pthread_mutex_lock(&m_mutex);
+            set_state(WORKER_DONE);
+        }
+
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    thctl_worker::thctl_worker(const string& nm):
+        m_name(nm),
+        m_thread(),
+        m_mutex(),
+        m_notify(),
+        m_state(WORKER_IDLE),
+        m_job(),
+        m_request(),
+        m_error() {
+        pthread_mutex_init(&m_mutex, nullptr);
+        pthread_cond_init(&m_notify, nullptr);
+
+        if (pthread_create(&m_thread, NULL, &thctl_worker::thread_func, this))
+            VCML_ERROR("failed to create worker thread %s", name());
+
+        // thread names are limited to 16 characters including terminator
+        string thname = m_name.substr(0, 15);
+        if (pthread_setname_np(m_thread, thname.c_str()))
+            VCML_ERROR("failed to name worker thread %s", name());
+    }
+
+    thctl_worker::~thctl_worker() {
+        pthread_mutex_lock(&m_mutex);
+        set_state(WORKER_EXIT);
+        pthread_mutex_unlock(&m_mutex);
+
+        pthread_join(m_thread, NULL);
+        pthread_cond_destroy(&m_notify);
+        pthread_mutex_destroy(&m_mutex);
+    }
+
+    void thctl_worker::start(const function<void()>& job) {
+        pthread_mutex_lock(&m_mutex);
+        VCML_ERROR_ON(!is_idle(), "worker %s is still busy", name());
+        m_job = job;
+        m_error = nullptr;
+        set_state(WORKER_READY);
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    void thctl_worker::resume() {
+        pthread_mutex_lock(&m_mutex);
+        VCML_ERROR_ON(m_state != WORKER_READY, "worker %s not ready", name());
+        set_state(WORKER_RUNNING);
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    void thctl_worker::join() {
+        pthread_mutex_lock(&m_mutex);
+        while (m_state == WORKER_RUNNING)
+            pthread_cond_wait(&m_notify, &m_mutex);
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    void thctl_worker::finish() {
+        pthread_mutex_lock(&m_mutex);
+        VCML_ERROR_ON(!is_done(), "worker %s has not finished", name());
+        m_job = nullptr;
+        set_state(WORKER_IDLE);
+        pthread_mutex_unlock(&m_mutex);
+
+        if (m_error) {
+            std::exception_ptr error = m_error;
+            m_error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    void thctl_worker::request(const function<void()>& func) {
+        VCML_ERROR_ON(thctl_current_worker() != this,
+                      "worker %s request from foreign thread", name());
+
+        pthread_mutex_lock(&m_mutex);
+        m_request = func;
+        set_state(WORKER_REQUEST);
+        wait_state(WORKER_RUNNING);
+        bool exiting = m_state == WORKER_EXIT;
+        std::exception_ptr error = m_error;
+        m_error = nullptr;
+        pthread_mutex_unlock(&m_mutex);
+
+        if (exiting)
+            throw thctl_worker_exit();
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    void thctl_worker::run_request() {
+        VCML_ERROR_ON(!is_request(), "worker %s has no request", name());
+
+        // exceptions are forwarded and rethrown from the worker thread
+        try {
+            m_request();
+        } catch (...) {
+            m_error = std::current_exception();
+        }
+
+        pthread_mutex_lock(&m_mutex);
+        m_request = nullptr;
+        set_state(WORKER_READY);
+        pthread_mutex_unlock(&m_mutex);
+    }
+
 #ifdef SNPS_VP_SC_VERSION
     static void snps_enter_critical(void* unused) {
         (void)unused;
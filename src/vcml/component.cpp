@@ -83,9 +83,14 @@ namespace vcml {
         module(nm),
         m_curclk(),
         m_offsets(),
+        m_last_proc(nullptr),
+        m_last_offset(nullptr),
         m_master_sockets(),
         m_slave_sockets(),
         allow_dmi("allow_dmi", dmi),
+        dmi_prefetch("dmi_prefetch", false),
+        mmio_dmi("mmio_dmi", false),
+        exmon_granule("exmon_granule", 64),
         CLOCK("CLOCK"),
         RESET("RESET") {
         SC_METHOD(clock_handler);
@@ -137,13 +142,47 @@ namespace vcml {
         return sc_time(1.0 / CLOCK.read(), SC_SEC);
     }
 
+    // tlm_global_quantum is a singleton, so its value can be referenced
+    // directly instead of fetching it for every needs_sync call
+    static const sc_time& global_quantum =
+        tlm::tlm_global_quantum::instance().get();
+
+    sc_time& component::offset_slot(sc_process_b* proc) {
+        // only needs a hash lookup when a different process than before
+        // asks for its offset
+        if (proc != m_last_proc || m_last_offset == nullptr) {
+            m_last_offset = &m_offsets[proc];
+            m_last_proc = proc;
+        }
+
+        return *m_last_offset;
+    }
+
+    // worker threads keep a pointer to the local time offset of the process
+    // they run for, so that only the first lookup needs the SystemC thread
+    static thread_local const component* g_worker_comp = nullptr;
+    static thread_local sc_time* g_worker_offset = nullptr;
+
     sc_time& component::local_time(sc_process_b* proc) {
+        if (proc == nullptr && thctl_is_worker_thread()) {
+            if (g_worker_comp != this) {
+                sc_time* local = nullptr;
+                thctl_current_worker()->request([&]() {
+                    local = &offset_slot(sc_get_current_process_b());
+                });
+
+                g_worker_comp = this;
+                g_worker_offset = local;
+            }
+
+            update_local_time(*g_worker_offset);
+            return *g_worker_offset;
+        }
+
         if (proc == nullptr)
             proc = sc_get_current_process_b();
-        if (!stl_contains(m_offsets, proc))
-             m_offsets[proc] = SC_ZERO_TIME;
 
-        sc_time& local = m_offsets[proc];
+        sc_time& local = offset_slot(proc);
         update_local_time(local);
         return local;
     }
@@ -153,16 +192,24 @@ namespace vcml {
     }
 
     bool component::needs_sync(sc_process_b* proc) {
+        // workers always run on behalf of an SC_THREAD
+        if (proc == nullptr && thctl_is_worker_thread())
+            return local_time() >= global_quantum;
+
         if (proc == nullptr)
             proc = sc_get_current_process_b();
         if (!is_thread(proc))
             return false;
 
-        sc_time quantum = tlm::tlm_global_quantum::instance().get();
-        return local_time(proc) >= quantum;
+        return local_time(proc) >= global_quantum;
     }
 
     void component::sync(sc_process_b* proc) {
+        if (proc == nullptr && thctl_is_worker_thread()) {
+            thctl_current_worker()->request([&]() { sync(); });
+            return;
+        }
+
         if (proc == nullptr)
             proc = sc_get_current_process_b();
         if (proc == nullptr || proc->proc_kind() != sc_core::SC_THREAD_PROC_)
@@ -219,10 +266,10 @@ namespace vcml {
                                 sc_time& dt) {
         wait_clock_reset();
 
-        sc_process_b* proc = current_thread();
-        m_offsets[proc] = dt;
+        sc_time& offset = offset_slot(current_thread());
+        offset = dt;
         transport(tx, tx_get_sbi(tx));
-        dt = m_offsets[proc];
+        dt = offset;
     }
 
     unsigned int component::transport_dbg(slave_socket* origin,
@@ -52,9 +52,43 @@ namespace vcml {
     }
 
 
+    void dmi_cache::carve(const range& r) {
+        entry_map::iterator it = m_entries.lower_bound(r.start);
+        if (it == m_entries.end() || it->second.get_start_address() > r.end)
+            return;
+
+        m_mru = m_entries.end();
+
+        tlm_dmi& head = it->second;
+        if (head.get_start_address() < r.start) {
+            tlm_dmi front(head);
+            front.set_end_address(r.start - 1);
+
+            // r lies strictly inside a single entry: split it in two
+            if (head.get_end_address() > r.end) {
+                dmi_set_start_address(head, r.end + 1);
+                m_entries.emplace_hint(it, r.start - 1, front);
+                return;
+            }
+
+            it = m_entries.erase(it);
+            m_entries.emplace_hint(it, r.start - 1, front);
+        }
+
+        while (it != m_entries.end() &&
+               it->second.get_start_address() <= r.end) {
+            if (it->second.get_end_address() > r.end) {
+                dmi_set_start_address(it->second, r.end + 1);
+                break;
+            }
+
+            it = m_entries.erase(it);
+        }
+    }
+
     dmi_cache::dmi_cache():
-        m_limit(16),
-        m_entries() {
+        m_entries(),
+        m_mru(m_entries.end()) {
         /* nothing to do */
     }
 
@@ -62,25 +96,45 @@ namespace vcml {
         /* nothing to do */
     }
 
+    vector<tlm_dmi> dmi_cache::get_entries() const {
+        vector<tlm_dmi> entries;
+        entries.reserve(m_entries.size());
+        for (const auto& it : m_entries)
+            entries.push_back(it.second);
+        return entries;
+    }
+
     void dmi_cache::insert(const tlm_dmi& dmi) {
         tlm_dmi merged(dmi);
-        while (true) {
-            vector<tlm_dmi>::iterator it = std::find_if(m_entries.begin(),
-                m_entries.end(), [merged] (const tlm_dmi& entry) -> bool {
-                return dmi_is_mergeable(merged, entry);
-            });
-
-            if (it == m_entries.end()) {
-                m_entries.insert(m_entries.begin(), merged);
-                break;
+        m_mru = m_entries.end();
+
+        // merging may grow the region so that it reaches further neighbours
+        bool done = false;
+        while (!done) {
+            done = true;
+
+            u64 lo = merged.get_start_address();
+            u64 hi = merged.get_end_address();
+            entry_map::iterator it;
+            for (it = m_entries.lower_bound(lo > 0 ? lo - 1 : lo);
+                 it != m_entries.end(); it++) {
+                u64 s = it->second.get_start_address();
+                if (s > hi && s - hi > 1)
+                    break;
+
+                if (dmi_is_mergeable(merged, it->second)) {
+                    merged = dmi_merge(merged, it->second);
+                    m_entries.erase(it);
+                    done = false;
+                    break;
+                }
             }
+        }
 
-            merged = dmi_merge(merged, *it);
-            m_entries.erase(it, it + 1);
-        };
+        // the new region supersedes anything it overlaps with
+        carve(merged);
 
-        if (m_entries.size() > m_limit)
-            m_entries.resize(m_limit);
+        m_mru = m_entries.emplace(merged.get_end_address(), merged).first;
     }
 
     void dmi_cache::invalidate(u64 start, u64 end) {
@@ -88,40 +142,31 @@ namespace vcml {
     }
 
     void dmi_cache::invalidate(const range& r) {
-        vector<tlm_dmi> entries(m_entries.rbegin(), m_entries.rend());
-        m_entries.clear();
-
-        for (auto dmi : entries) {
-            if (!r.overlaps(dmi)) {
-                insert(dmi);
-                continue;
-            }
-
-            if (r.start > 0) {
-                tlm_dmi front(dmi);
-                front.set_end_address(r.start - 1);
-                if (front.get_start_address() < front.get_end_address())
-                    insert(front);
-            }
+        carve(r);
+    }
 
-            if (r.end != (u64)-1) {
-                tlm_dmi back(dmi);
-                dmi_set_start_address(back, r.end + 1);
-                if (back.get_start_address() < back.get_end_address())
-                    insert(back);
-            }
-        }
+    bool dmi_cache::overlaps(const range& r) const {
+        auto it = m_entries.lower_bound(r.start);
+        return it != m_entries.end() && it->second.get_start_address() <= r.end;
     }
 
     bool dmi_cache::lookup(const range& r, tlm_command c, tlm_dmi& out) {
-        for (unsigned int i = 0; i < m_entries.size(); i++) {
-            if (r.inside(m_entries[i]) && dmi_check_access(m_entries[i], c)) {
-                std::swap(m_entries[i], m_entries[0]);
-                out = m_entries[0];
-                return true;
-            }
+        if (m_mru != m_entries.end() && r.inside(m_mru->second) &&
+            dmi_check_access(m_mru->second, c)) {
+            out = m_mru->second;
+            return true;
         }
-        return false;
+
+        entry_map::iterator it = m_entries.lower_bound(r.start);
+        if (it == m_entries.end())
+            return false;
+
+        if (!r.inside(it->second) || !dmi_check_access(it->second, c))
+            return false;
+
+        m_mru = it;
+        out = it->second;
+        return true;
     }
 
 }
@@ -20,9 +20,36 @@
 
 namespace vcml {
 
-    exmon::exmon():
-        m_locks() {
-        /* nothing to do */
+    range exmon::align(const range& r) const {
+        return range(r.start & ~(m_granule - 1), r.end | (m_granule - 1));
+    }
+
+    void exmon::reserve(const range& r) {
+        for (u64 g = r.start >> m_shift; g <= r.end >> m_shift; g++)
+            m_granules[g]++;
+    }
+
+    void exmon::release(const range& r) {
+        for (u64 g = r.start >> m_shift; g <= r.end >> m_shift; g++) {
+            auto it = m_granules.find(g);
+            if (it != m_granules.end() && --it->second == 0)
+                m_granules.erase(it);
+        }
+    }
+
+    void exmon::set_granule(u64 granule) {
+        VCML_ERROR_ON(!is_pow2(granule), "invalid granule size %lu", granule);
+        VCML_ERROR_ON(has_locks(), "cannot change granule while locked");
+        m_granule = granule;
+        m_shift = ctz(granule);
+    }
+
+    exmon::exmon(u64 granule):
+        m_granule(),
+        m_shift(),
+        m_locks(),
+        m_granules() {
+        set_granule(granule);
     }
 
     exmon::~exmon() {
@@ -30,71 +57,111 @@ namespace vcml {
     }
 
     bool exmon::has_lock(int cpu, const range& r) const {
-        for (auto lock : m_locks)
-            if (lock.cpu == cpu && lock.addr.includes(r))
-                return true;
+        for (const exlock& lock : m_locks)
+            if (lock.cpu == cpu)
+                return lock.addr.includes(r);
         return false;
     }
 
     bool exmon::add_lock(int cpu, const range& r) {
         assert(cpu >= 0);
         break_locks(cpu);
-        m_locks.push_back({cpu, r});
+        m_locks.push_back({cpu, align(r)});
+        reserve(m_locks.back().addr);
         return true;
     }
 
+    bool exmon::conflicts(const range& r) const {
+        if (m_locks.empty())
+            return false;
+
+        // large ranges are cheaper to check against the few reservations
+        u64 first = r.start >> m_shift;
+        u64 last = r.end >> m_shift;
+        if (last - first >= m_granules.size()) {
+            for (const exlock& lock : m_locks)
+                if (lock.addr.overlaps(r))
+                    return true;
+            return false;
+        }
+
+        for (u64 g = first; g <= last; g++)
+            if (m_granules.count(g))
+                return true;
+        return false;
+    }
+
     void exmon::break_locks(int cpu) {
         assert(cpu >= 0);
-        m_locks.erase(std::remove_if(m_locks.begin(), m_locks.end(),
-            [cpu] (const exlock& lock) -> bool {
-                return lock.cpu == cpu;
-        }), m_locks.end());
+        for (auto it = m_locks.begin(); it != m_locks.end(); it++) {
+            if (it->cpu == cpu) {
+                release(it->addr);
+                m_locks.erase(it);
+                return;
+            }
+        }
     }
 
     void exmon::break_locks(const range& r) {
-        m_locks.erase(std::remove_if(m_locks.begin(), m_locks.end(),
-            [r] (const exlock& lock) -> bool {
-                return lock.addr.overlaps(r);
-        }), m_locks.end());
+        if (!conflicts(r))
+            return;
+
+        for (auto it = m_locks.begin(); it != m_locks.end();) {
+            if (it->addr.overlaps(r)) {
+                release(it->addr);
+                it = m_locks.erase(it);
+            } else {
+                it++;
+            }
+        }
     }
 
     bool exmon::update(tlm_generic_payload& tx) {
-        for (auto lock : m_locks)
-            if (lock.addr.overlaps(tx))
-                tx.set_dmi_allowed(false);
+        sbiext* ex = tx.get_extension<sbiext>();
+        bool excl = ex != nullptr && ex->is_excl;
+
+        // nobody holds a reservation and nobody wants one
+        if (m_locks.empty() && !excl)
+            return true;
+
+        const range addr(tx);
+        if (conflicts(addr))
+            tx.set_dmi_allowed(false);
 
         bool proceed = true;
-        sbiext* ex = tx.get_extension<sbiext>();
-        if (ex != nullptr && ex->is_excl) {
+        if (excl) {
             if (tx.is_read())
-                add_lock(ex->cpuid, tx);
+                add_lock(ex->cpuid, addr);
             if (tx.is_write())
-                ex->is_excl = has_lock(ex->cpuid, tx);
+                ex->is_excl = has_lock(ex->cpuid, addr);
             proceed = ex->is_excl;
         }
 
+        // writes clear all reservations on the granules they touch
         if (tx.is_write())
-            break_locks(tx); // increase range to invalidate entire cache line?
+            break_locks(addr);
 
         return proceed;
     }
 
     bool exmon::override_dmi(const tlm_generic_payload& tx, tlm_dmi& dmi) {
-        for (auto lock : m_locks) {
-            if (lock.addr.includes(tx.get_address())) {
-                dmi.set_start_address(0);
-                dmi.set_end_address((sc_dt::uint64)-1);
-                dmi.allow_read_write();
-                return false;
-            }
+        if (m_locks.empty())
+            return true;
+
+        const u64 addr = tx.get_address();
+        if (conflicts(range(addr, addr))) {
+            dmi.set_start_address(0);
+            dmi.set_end_address((sc_dt::uint64)-1);
+            dmi.allow_read_write();
+            return false;
         }
 
-        for (auto lock : m_locks) {
-            if (lock.addr.end < tx.get_address() &&
+        for (const exlock& lock : m_locks) {
+            if (lock.addr.end < addr &&
                 dmi.get_start_address() <= lock.addr.end) {
                 dmi_set_start_address(dmi, lock.addr.end + 1);
             }
-            if (lock.addr.start > tx.get_address() &&
+            if (lock.addr.start > addr &&
                 dmi.get_end_address() >= lock.addr.start) {
                 dmi.set_end_address(lock.addr.start - 1);
             }
@@ -22,7 +22,7 @@ namespace vcml {
 
     log_file::log_file(const string& filename):
         logger(LOG_ERROR, LOG_DEBUG),
-        m_file(filename.c_str(), std::ios_base::out) {
+        m_writer(filename) {
         // nothing to do
     }
 
@@ -31,7 +31,9 @@ namespace vcml {
     }
 
     void log_file::log_line(log_level lvl, const char* line) {
-        m_file << line << std::endl;
+        m_writer.write_line(line);
+        if (lvl == LOG_ERROR)
+            m_writer.flush();
     }
 
 }
@@ -0,0 +1,184 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <semaphore.h>
+
+#include "vcml/logging/log_limiter.h"
+
+namespace vcml {
+
+    static const time_t LOG_SUMMARY_INTERVAL_S = 1;
+
+    static pthread_mutex_t g_limiters_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+    // never destroyed, static limiters may outlive any static list
+    static vector<log_limiter*>& all_limiters() {
+        static vector<log_limiter*>* limiters = new vector<log_limiter*>();
+        return *limiters;
+    }
+
+    // suppressed messages are summarized from a host thread once per second,
+    // so that quiet call sites get reported without touching simulation time
+    static pthread_once_t g_summary_once = PTHREAD_ONCE_INIT;
+    static pthread_t g_summary_thread;
+    static sem_t g_summary_notify;
+    static atomic<bool> g_summary_running(false);
+
+    static void* summary_thread(void* arg) {
+        (void)arg;
+        while (g_summary_running) {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_sec += LOG_SUMMARY_INTERVAL_S;
+            sem_timedwait(&g_summary_notify, &ts);
+            if (g_summary_running)
+                log_limiter::flush_all();
+        }
+
+        return nullptr;
+    }
+
+    static void stop_summaries() {
+        g_summary_running = false;
+        sem_post(&g_summary_notify);
+        pthread_join(g_summary_thread, NULL);
+        sem_destroy(&g_summary_notify);
+    }
+
+    static void start_summaries() {
+        if (sem_init(&g_summary_notify, 0, 0))
+            VCML_ERROR("failed to create log summary semaphore");
+
+        g_summary_running = true;
+        if (pthread_create(&g_summary_thread, NULL, &summary_thread, NULL))
+            VCML_ERROR("failed to create log summary thread");
+        if (pthread_setname_np(g_summary_thread, "vcml_logsum"))
+            VCML_ERROR("failed to name log summary thread");
+
+        atexit(&stop_summaries);
+    }
+
+    void log_limiter::report(log_level lvl, u64 suppressed) const {
+        string msg = mkstr("suppressed %llu similar messages", suppressed);
+        if (m_obj != nullptr)
+            logger::log(lvl, m_obj, msg);
+        else
+            logger::log(lvl, m_org, msg);
+    }
+
+    log_limiter::log_limiter(const sc_object* org,
+                             const function<double()>& clock):
+        m_obj(org),
+        m_org(),
+        m_clock(clock),
+        m_mutex(),
+        m_buckets() {
+        pthread_mutex_init(&m_mutex, NULL);
+
+        pthread_mutex_lock(&g_limiters_mutex);
+        all_limiters().push_back(this);
+        pthread_mutex_unlock(&g_limiters_mutex);
+    }
+
+    log_limiter::log_limiter(const string& org,
+                             const function<double()>& clock):
+        m_obj(nullptr),
+        m_org(org),
+        m_clock(clock),
+        m_mutex(),
+        m_buckets() {
+        pthread_mutex_init(&m_mutex, NULL);
+
+        pthread_mutex_lock(&g_limiters_mutex);
+        all_limiters().push_back(this);
+        pthread_mutex_unlock(&g_limiters_mutex);
+    }
+
+    log_limiter::~log_limiter() {
+        pthread_mutex_lock(&g_limiters_mutex);
+        stl_remove_erase(all_limiters(), this);
+        pthread_mutex_unlock(&g_limiters_mutex);
+
+        pthread_mutex_destroy(&m_mutex);
+    }
+
+    bool log_limiter::allow(log_level lvl, const char* format,
+                            unsigned int rate) {
+        if (rate == 0)
+            return true;
+
+        double now = m_clock();
+        u64 suppressed = 0;
+
+        pthread_mutex_lock(&m_mutex);
+
+        auto it = m_buckets.find(format);
+        if (it == m_buckets.end()) {
+            bucket b = { (double)rate, now, 0, lvl };
+            it = m_buckets.insert({ format, b }).first;
+        }
+
+        // refill with rate tokens per second, allowing bursts of that size
+        bucket& b = it->second;
+        b.tokens = min(b.tokens + (now - b.stamp) * rate, (double)rate);
+        b.stamp = now;
+
+        bool allowed = b.tokens >= 1.0;
+        if (allowed) {
+            b.tokens -= 1.0;
+            suppressed = b.suppressed;
+            b.suppressed = 0;
+        } else {
+            b.suppressed++;
+        }
+
+        pthread_mutex_unlock(&m_mutex);
+
+        if (!allowed)
+            pthread_once(&g_summary_once, &start_summaries);
+
+        if (suppressed > 0)
+            report(lvl, suppressed);
+
+        return allowed;
+    }
+
+    void log_limiter::flush() {
+        vector<std::pair<log_level, u64>> pending;
+
+        pthread_mutex_lock(&m_mutex);
+        for (auto& it : m_buckets) {
+            if (it.second.suppressed > 0) {
+                pending.push_back({ it.second.level, it.second.suppressed });
+                it.second.suppressed = 0;
+            }
+        }
+        pthread_mutex_unlock(&m_mutex);
+
+        for (auto& p : pending)
+            report(p.first, p.second);
+    }
+
+    void log_limiter::flush_all() {
+        pthread_mutex_lock(&g_limiters_mutex);
+        for (log_limiter* limiter : all_limiters())
+            limiter->flush();
+        pthread_mutex_unlock(&g_limiters_mutex);
+    }
+
+}
@@ -0,0 +1,235 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <signal.h>
+
+#include "vcml/logging/log_writer.h"
+#include "vcml/common/report.h"
+
+namespace vcml {
+
+    static const long LOG_WRITER_LATENCY_MS = 10;
+    static const size_t LOG_WRITER_BATCH = 64 * KiB;
+
+    static pthread_mutex_t g_writers_mutex = PTHREAD_MUTEX_INITIALIZER;
+    static vector<log_writer*> g_writers;
+
+    static bool g_hooks_installed = false;
+    static struct sigaction g_oldact;
+
+    static void handle_abort(int sig) {
+        log_writer::flush_all();
+
+        // raised again once we return, now using the previous handler
+        sigaction(SIGABRT, &g_oldact, nullptr);
+        raise(sig);
+    }
+
+    // pending lines must not get lost on exit() and abort(), e.g. when
+    // VCML_ERROR fires, so flush all writers in both cases
+    static void install_hooks() {
+        if (g_hooks_installed)
+            return;
+
+        g_hooks_installed = true;
+        atexit(&log_writer::flush_all);
+
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sigemptyset(&sa.sa_mask);
+        sa.sa_handler = &handle_abort;
+        if (sigaction(SIGABRT, &sa, &g_oldact) < 0)
+            VCML_ERROR("failed to install SIGABRT handler");
+    }
+
+    void* log_writer::thread_func(void* arg) {
+        log_writer* writer = (log_writer*)arg;
+        writer->writer();
+        return nullptr;
+    }
+
+    void log_writer::setup() {
+        m_stub.next = nullptr;
+        m_stub.size = 0;
+        m_buffer.reserve(LOG_WRITER_BATCH);
+
+        if (sem_init(&m_notify, 0, 0))
+            VCML_ERROR("failed to create log writer semaphore");
+        if (pthread_create(&m_thread, NULL, &log_writer::thread_func, this))
+            VCML_ERROR("failed to create log writer thread");
+        if (pthread_setname_np(m_thread, "vcml_log"))
+            VCML_ERROR("failed to name log writer thread");
+
+        pthread_mutex_lock(&g_writers_mutex);
+        install_hooks();
+        g_writers.push_back(this);
+        pthread_mutex_unlock(&g_writers_mutex);
+    }
+
+    void log_writer::write_buffer() {
+        const char* ptr = m_buffer.c_str();
+        size_t size = m_buffer.size();
+
+        while (size > 0) {
+            ssize_t n = ::write(m_fd, ptr, size);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                break; // nowhere left to report this
+            ptr += n;
+            size -= n;
+        }
+
+        m_buffer.clear();
+    }
+
+    void log_writer::drain() {
+        u64 count = 0;
+        line* next = nullptr;
+
+        while ((next = m_tail->next.load(std::memory_order_acquire))) {
+            m_buffer.append(next->text, next->size);
+
+            line* prev = m_tail;
+            m_tail = next;
+            if (prev != &m_stub)
+                free(prev);
+
+            count++;
+            if (m_buffer.size() >= LOG_WRITER_BATCH)
+                write_buffer();
+        }
+
+        write_buffer();
+        m_written += count;
+    }
+
+    void log_writer::writer() {
+        while (m_running) {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += LOG_WRITER_LATENCY_MS * 1000000;
+            if (ts.tv_nsec >= 1000000000) {
+                ts.tv_nsec -= 1000000000;
+                ts.tv_sec++;
+            }
+
+            sem_timedwait(&m_notify, &ts);
+            drain();
+        }
+
+        drain();
+    }
+
+    log_writer::log_writer(int fd):
+        m_fd(fd),
+        m_owner(false),
+        m_stub(),
+        m_tail(&m_stub),
+        m_head(&m_stub),
+        m_pushed(0),
+        m_written(0),
+        m_running(true),
+        m_notify(),
+        m_thread(),
+        m_buffer() {
+        setup();
+    }
+
+    log_writer::log_writer(const string& filename):
+        m_fd(-1),
+        m_owner(true),
+        m_stub(),
+        m_tail(&m_stub),
+        m_head(&m_stub),
+        m_pushed(0),
+        m_written(0),
+        m_running(true),
+        m_notify(),
+        m_thread(),
+        m_buffer() {
+        m_fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        VCML_ERROR_ON(m_fd < 0, "cannot open log file %s: %s",
+                      filename.c_str(), strerror(errno));
+        setup();
+    }
+
+    log_writer::~log_writer() {
+        pthread_mutex_lock(&g_writers_mutex);
+        stl_remove_erase(g_writers, this);
+        pthread_mutex_unlock(&g_writers_mutex);
+
+        m_running = false;
+        sem_post(&m_notify);
+        pthread_join(m_thread, NULL);
+        sem_destroy(&m_notify);
+
+        if (m_tail != &m_stub)
+            free(m_tail);
+
+        if (m_owner)
+            close(m_fd);
+    }
+
+    void log_writer::write_line(const char* text, const char* prefix,
+                                const char* suffix) {
+        size_t lp = strlen(prefix);
+        size_t lt = strlen(text);
+        size_t ls = strlen(suffix);
+        size_t size = lp + lt + ls + 1;
+
+        line* l = (line*)malloc(sizeof(line) + size);
+        VCML_ERROR_ON(l == nullptr, "out of memory");
+
+        new (&l->next) atomic<line*>(nullptr);
+        l->size = size;
+        memcpy(l->text, prefix, lp);
+        memcpy(l->text + lp, text, lt);
+        memcpy(l->text + lp + lt, suffix, ls);
+        l->text[size - 1] = '\n';
+
+        line* prev = m_head.exchange(l, std::memory_order_acq_rel);
+        prev->next.store(l, std::memory_order_release);
+        m_pushed++;
+    }
+
+    void log_writer::flush() {
+        // only uses atomics and sem_post, so this is safe to use from the
+        // crash handler; gives up after one second in that case
+        u64 target = m_pushed;
+        for (int i = 0; i < 10000 && m_written < target; i++) {
+            sem_post(&m_notify);
+            struct timespec ts = { 0, 100000 }; // 100us
+            nanosleep(&ts, nullptr);
+        }
+    }
+
+    void log_writer::flush_all() {
+        bool locked = pthread_mutex_trylock(&g_writers_mutex) == 0;
+        for (log_writer* writer : g_writers)
+            writer->flush();
+        if (locked)
+            pthread_mutex_unlock(&g_writers_mutex);
+    }
+
+}
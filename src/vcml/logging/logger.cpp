@@ -17,6 +17,8 @@
  ******************************************************************************/
 
 #include "vcml/logging/logger.h"
+#include "vcml/logging/trace_file.h"
+#include "vcml/logging/log_limiter.h"
 #include "vcml/component.h"
 
 namespace vcml {
@@ -28,7 +30,10 @@ namespace vcml {
     bool logger::print_origin = true;
     bool logger::print_backtrace = true;
 
+    unsigned int logger::log_rate = 0;
+
     size_t logger::trace_name_length = 20;
+    string logger::trace_filter = "";
 
     const char* logger::prefix[NUM_LOG_LEVELS] = {
             [LOG_ERROR] = "E",
@@ -46,45 +51,112 @@ namespace vcml {
             [LOG_TRACE] = "trace"
     };
 
-    void logger::print_prefix(ostream& os, log_level lvl, const sc_time& t) {
-        os << "[" << vcml::logger::prefix[lvl];
+    static void append_dec(string& buf, u64 val, size_t width = 0) {
+        char digits[20];
+        size_t n = 0;
+
+        do {
+            digits[n++] = '0' + val % 10;
+            val /= 10;
+        } while (val > 0);
+
+        for (size_t i = n; i < width; i++)
+            buf += '0';
+        while (n > 0)
+            buf += digits[--n];
+    }
+
+    void logger::print_prefix(string& buf, log_level lvl, const sc_time& t) {
+        buf += '[';
+        buf += prefix[lvl];
 
         if (print_time_stamp) {
-            u64 seconds = time_to_ns(t) / 1000000000ull;
-            u64 nanosec = time_to_ns(t) % 1000000000ull;
-            os << " " << std::dec << seconds
-               << "." << std::setw(9) << std::setfill('0') << nanosec;
+            // time resolutions coarser than 1ns have no ticks per ns
+            static const u64 ticks_per_ns = sc_time(1.0, SC_NS).value();
+            u64 ns = ticks_per_ns ? t.value() / ticks_per_ns
+                                  : (u64)(t.to_seconds() * 1e9);
+            buf += ' ';
+            append_dec(buf, ns / 1000000000ull);
+            buf += '.';
+            append_dec(buf, ns % 1000000000ull, 9);
         }
 
-        if (print_delta_cycle)
-            os << " <" << sc_delta_count() << ">";
+        if (print_delta_cycle) {
+            buf += " <";
+            append_dec(buf, sc_delta_count());
+            buf += '>';
+        }
 
-        os << "]";
+        buf += ']';
     }
 
-    void logger::print_trace(bool forward, const string& org,
+    // reused for every message to avoid allocations on the producer side
+    static thread_local string g_log_buffer;
+
+    void logger::print_lines(log_level lvl, const char* org,
+                             const sc_time& t, const string& msg) {
+        const vector<logger*>& outputs = loggers[lvl];
+        if (outputs.empty())
+            return;
+
+        string& buf = g_log_buffer;
+        buf.clear();
+        print_prefix(buf, lvl, t);
+
+        if (print_origin && org != nullptr && *org != '\0') {
+            buf += ' ';
+            buf += org;
+            buf += ':';
+        }
+
+        buf += ' ';
+        size_t len = buf.length();
+
+        size_t pos = 0;
+        while (pos <= msg.length()) {
+            size_t end = msg.find('\n', pos);
+            if (end == string::npos)
+                end = msg.length();
+
+            buf.resize(len);
+            buf.append(msg, pos, end - pos);
+            for (auto out: outputs)
+                out->log_line(lvl, buf.c_str());
+
+            pos = end + 1;
+        }
+    }
+
+    void logger::print_trace(bool forward, const char* name,
                              const tlm_generic_payload& tx,
                              const sc_time& dt) {
+        trace_file* tracer = trace_file::instance();
+        if (tracer != nullptr)
+            tracer->record(forward, name, tx, sc_time_stamp() + dt);
+
         if (!would_log(LOG_TRACE))
             return;
 
-        stringstream ss;
-        print_prefix(ss, LOG_TRACE, sc_time_stamp() + dt);
+        string& buf = g_log_buffer;
+        buf.clear();
+        print_prefix(buf, LOG_TRACE, sc_time_stamp() + dt);
 
-        if (!org.empty()) {
-            if (trace_name_length < org.length())
-                trace_name_length = org.length();
+        size_t len = strlen(name);
+        if (len > 0) {
+            if (trace_name_length < len)
+                trace_name_length = len;
 
-            ss << " " << org << ":";
-            for (size_t i = org.length(); i < trace_name_length; i++)
-                ss << " ";
+            buf += ' ';
+            buf += name;
+            buf += ':';
+            buf.append(trace_name_length - len, ' ');
         }
 
-        ss << (forward ? ">> " : "<< ");
-        ss << tlm_transaction_to_str(tx);
+        buf += (forward ? ">> " : "<< ");
+        buf += tlm_transaction_to_str(tx);
 
         for (auto out: loggers[LOG_TRACE])
-            out->log_line(LOG_TRACE, ss.str().c_str());
+            out->log_line(LOG_TRACE, buf.c_str());
     }
 
     void logger::register_logger() {
@@ -136,18 +208,27 @@ namespace vcml {
         if (comp && is_thread())
             now += comp->local_time();
 
-        stringstream ss;
-        print_prefix(ss, lvl, now);
+        print_lines(lvl, org.c_str(), now, msg);
+    }
+
+    void logger::log(log_level lvl, const sc_object* org, const string& msg) {
+        if (!would_log(lvl))
+            return;
 
-        if (print_origin && !org.empty())
-            ss << " " << org << ":";
+        sc_time now = sc_time_stamp();
+        if (org == nullptr) {
+            print_lines(lvl, "", now, msg);
+            return;
+        }
 
-        vector<string> lines = split(msg, '\n');
-        for (auto line : lines) {
-            string full = ss.str() + " " + line;
-            for (auto out: loggers[lvl])
-                out->log_line(lvl, full.c_str());
+        if (print_time_stamp && is_thread()) {
+            component* comp = dynamic_cast<component*>(
+                const_cast<sc_object*>(org));
+            if (comp != nullptr)
+                now += comp->local_time();
         }
+
+        print_lines(lvl, org->name(), now, msg);
     }
 
     void logger::log(const report& rep) {
@@ -165,12 +246,25 @@ namespace vcml {
         log(LOG_ERROR, rep.origin(), ss.str());
     }
 
-    void logger::trace_fw(const string& org, const tlm_generic_payload& tx,
+    // call sites are identified by their format string, so the global log
+    // functions share one limiter and do not need to know their origin
+    static log_limiter& global_limiter() {
+        static log_limiter limiter("");
+        return limiter;
+    }
+
+    bool logger::check_rate(log_level lvl, const char* format) {
+        if (log_rate == 0)
+            return true;
+        return global_limiter().allow(lvl, format, log_rate);
+    }
+
+    void logger::trace_fw(const char* org, const tlm_generic_payload& tx,
                           const sc_time& dt) {
         print_trace(true, org, tx, dt);
     }
 
-    void logger::trace_bw(const string& org, const tlm_generic_payload& tx,
+    void logger::trace_bw(const char* org, const tlm_generic_payload& tx,
                           const sc_time& dt) {
         print_trace(false, org, tx, dt);
     }
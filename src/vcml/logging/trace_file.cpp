@@ -0,0 +1,252 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <sched.h>
+#include <time.h>
+#include <errno.h>
+#include <string.h>
+
+#include "vcml/logging/trace_file.h"
+#include "vcml/logging/logger.h"
+
+namespace vcml {
+
+    static const u64 TRACE_RING_SIZE = 16384;
+
+    // rings are written by a single thread and drained by the writer
+    struct trace_file::ring {
+        atomic<u64> head;
+        atomic<u64> tail;
+        std::unordered_map<const char*, u32> origins;
+        trace_record records[TRACE_RING_SIZE];
+
+        ring(): head(0), tail(0), origins() {}
+    };
+
+    // rings are tagged with the id of their trace file instead of its
+    // address, which a later trace file may reuse
+    static atomic<u64> g_next_id(1);
+    static thread_local u64 g_ring_owner = 0;
+    static thread_local void* g_ring = nullptr;
+
+    trace_file* trace_file::s_instance = nullptr;
+
+    trace_file::ring* trace_file::local_ring() {
+        if (g_ring_owner == m_id)
+            return (ring*)g_ring;
+
+        ring* r = new ring();
+        pthread_mutex_lock(&m_mutex);
+        m_rings.push_back(r);
+        pthread_mutex_unlock(&m_mutex);
+
+        g_ring_owner = m_id;
+        g_ring = r;
+        return r;
+    }
+
+    u32 trace_file::lookup_origin(ring* r, const char* org) {
+        auto it = r->origins.find(org);
+        if (it != r->origins.end())
+            return it->second;
+
+        string name(org);
+        pthread_mutex_lock(&m_mutex);
+        auto known = m_origins.find(name);
+        if (known != m_origins.end()) {
+            u32 id = known->second;
+            pthread_mutex_unlock(&m_mutex);
+            r->origins[org] = id;
+            return id;
+        }
+
+        u32 id = m_origins.size();
+        m_origins[name] = id;
+
+        // name records go straight to the file while holding the lock that
+        // also guards draining, so that they precede any record using id
+        trace_record rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.type = TRACE_RECORD_NAME;
+        rec.origin = id;
+        rec.size = name.length();
+        bool ok = fwrite(&rec, sizeof(rec), 1, m_file) == 1;
+
+        for (u32 i = 0; i < trace_name_records(rec.size); i++) {
+            trace_record chars;
+            size_t offset = i * sizeof(chars);
+            size_t length = min(sizeof(chars), name.length() - offset);
+            memset(&chars, 0, sizeof(chars));
+            memcpy(&chars, name.c_str() + offset, length);
+            ok &= fwrite(&chars, sizeof(chars), 1, m_file) == 1;
+        }
+
+        pthread_mutex_unlock(&m_mutex);
+
+        if (!ok)
+            log_error("failed writing trace file %s", filename());
+
+        r->origins[org] = id;
+        return id;
+    }
+
+    void trace_file::push(ring* r, const trace_record& rec) {
+        u64 head = r->head.load(std::memory_order_relaxed);
+        u64 tail = r->tail.load(std::memory_order_acquire);
+
+        // ring is full, give the writer a chance to catch up
+        while (head - tail >= TRACE_RING_SIZE) {
+            pthread_cond_signal(&m_notify);
+            sched_yield();
+            tail = r->tail.load(std::memory_order_acquire);
+        }
+
+        r->records[head % TRACE_RING_SIZE] = rec;
+        r->head.store(head + 1, std::memory_order_release);
+
+        if (head - tail == TRACE_RING_SIZE / 2)
+            pthread_cond_signal(&m_notify);
+    }
+
+    void trace_file::drain(ring* r) {
+        u64 tail = r->tail.load(std::memory_order_relaxed);
+        u64 head = r->head.load(std::memory_order_acquire);
+
+        while (tail != head) {
+            u64 idx = tail % TRACE_RING_SIZE;
+            u64 num = min(head - tail, TRACE_RING_SIZE - idx);
+            if (fwrite(r->records + idx, sizeof(trace_record), num,
+                       m_file) != num) {
+                log_error("failed writing trace file %s", filename());
+            }
+
+            tail += num;
+        }
+
+        r->tail.store(tail, std::memory_order_release);
+    }
+
+    void trace_file::writer() {
+        pthread_mutex_lock(&m_mutex);
+        while (m_running) {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += 10000000; // 10ms
+            if (ts.tv_nsec >= 1000000000) {
+                ts.tv_nsec -= 1000000000;
+                ts.tv_sec++;
+            }
+
+            pthread_cond_timedwait(&m_notify, &m_mutex, &ts);
+
+            for (ring* r : m_rings)
+                drain(r);
+        }
+
+        for (ring* r : m_rings)
+            drain(r);
+
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    void* trace_file::thread_func(void* arg) {
+        trace_file* tracer = (trace_file*)arg;
+        tracer->writer();
+        return nullptr;
+    }
+
+    trace_file::trace_file(const string& filename):
+        m_id(g_next_id++),
+        m_filename(filename),
+        m_file(nullptr),
+        m_thread(),
+        m_mutex(),
+        m_notify(),
+        m_running(true),
+        m_rings(),
+        m_origins() {
+        VCML_ERROR_ON(s_instance != nullptr, "trace file already opened");
+
+        m_file = fopen(filename.c_str(), "wb");
+        VCML_ERROR_ON(m_file == nullptr, "cannot open trace file %s: %s",
+                      filename.c_str(), strerror(errno));
+
+        trace_header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+        header.version = TRACE_VERSION;
+        header.record_size = sizeof(trace_record);
+        if (fwrite(&header, sizeof(header), 1, m_file) != 1)
+            VCML_ERROR("cannot write trace file %s", filename.c_str());
+
+        pthread_mutex_init(&m_mutex, nullptr);
+        pthread_cond_init(&m_notify, nullptr);
+
+        if (pthread_create(&m_thread, NULL, &trace_file::thread_func, this))
+            VCML_ERROR("failed to create trace writer thread");
+        if (pthread_setname_np(m_thread, "vcml_trace"))
+            VCML_ERROR("failed to name trace writer thread");
+
+        s_instance = this;
+    }
+
+    trace_file::~trace_file() {
+        s_instance = nullptr;
+
+        pthread_mutex_lock(&m_mutex);
+        m_running = false;
+        pthread_cond_signal(&m_notify);
+        pthread_mutex_unlock(&m_mutex);
+        pthread_join(m_thread, NULL);
+
+        for (ring* r : m_rings)
+            delete r;
+
+        if (g_ring_owner == m_id)
+            g_ring_owner = 0;
+
+        fclose(m_file);
+        pthread_cond_destroy(&m_notify);
+        pthread_mutex_destroy(&m_mutex);
+    }
+
+    void trace_file::record(bool forward, const char* org,
+                            const tlm_generic_payload& tx, const sc_time& t) {
+        ring* r = local_ring();
+
+        trace_record rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.time = time_to_ns(t);
+        rec.delta = sc_delta_count();
+        rec.addr = tx.get_address();
+        rec.origin = lookup_origin(r, org);
+        rec.size = tx.get_data_length();
+        rec.type = TRACE_RECORD_TX;
+        rec.flags = forward ? TRACE_FLAG_FORWARD : 0;
+        rec.command = tx.get_command();
+        rec.response = tx.get_response_status();
+
+        if (tx.get_data_ptr() != nullptr) {
+            rec.nbytes = min(rec.size, TRACE_DATA_BYTES);
+            memcpy(rec.data, tx.get_data_ptr(), rec.nbytes);
+        }
+
+        push(r, rec);
+    }
+
+}
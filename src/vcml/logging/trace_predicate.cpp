@@ -0,0 +1,95 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "vcml/logging/trace_predicate.h"
+
+namespace vcml {
+
+    static u64 parse_number(const string& spec, const string& str) {
+        char* end = nullptr;
+        u64 val = strtoull(str.c_str(), &end, 0);
+        if (str.empty() || *end != '\0')
+            VCML_ERROR("invalid number '%s' in trace filter '%s'",
+                       str.c_str(), spec.c_str());
+        return val;
+    }
+
+    trace_predicate::trace_predicate():
+        m_reads(true),
+        m_writes(true),
+        m_errors(false),
+        m_cpus(~0ull),
+        m_ranges() {
+        // nothing to do
+    }
+
+    trace_predicate::trace_predicate(const string& spec):
+        trace_predicate() {
+        compile(spec);
+    }
+
+    void trace_predicate::compile(const string& spec) {
+        bool reads = false;
+        bool writes = false;
+
+        m_errors = false;
+        m_cpus = ~0ull;
+        m_ranges.clear();
+
+        u64 cpus = 0;
+        for (string token : split(spec, ',')) {
+            token = trim(token);
+            if (token.empty())
+                continue;
+
+            if (token == "read") {
+                reads = true;
+            } else if (token == "write") {
+                writes = true;
+            } else if (token == "errors") {
+                m_errors = true;
+            } else if (token.find("cpu=") == 0) {
+                u64 cpu = parse_number(spec, token.substr(4));
+                VCML_ERROR_ON(cpu >= 64, "cpu %lu out of range in trace "
+                              "filter '%s'", cpu, spec.c_str());
+                cpus |= 1ull << cpu;
+            } else if (token.find("addr=") == 0) {
+                string addr = token.substr(5);
+                size_t sep = addr.find('-');
+                u64 lo = parse_number(spec, addr.substr(0, sep));
+                u64 hi = lo;
+                if (sep != string::npos)
+                    hi = parse_number(spec, addr.substr(sep + 1));
+                VCML_ERROR_ON(hi < lo, "invalid address range '%s' in trace "
+                              "filter '%s'", addr.c_str(), spec.c_str());
+                m_ranges.push_back(range(lo, hi));
+            } else {
+                VCML_ERROR("unknown token '%s' in trace filter '%s'",
+                           token.c_str(), spec.c_str());
+            }
+        }
+
+        // without any command given, all commands get traced
+        m_reads = reads || !writes;
+        m_writes = writes || !reads;
+
+        if (cpus != 0)
+            m_cpus = cpus;
+    }
+
+}
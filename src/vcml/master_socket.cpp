@@ -17,6 +17,7 @@
  ******************************************************************************/
 
 #include "vcml/master_socket.h"
+#include "vcml/slave_socket.h"
 
 namespace vcml {
 
@@ -24,10 +25,92 @@ namespace vcml {
                                                   sc_dt::uint64 end) {
         unmap_dmi(start, end);
         m_host->invalidate_direct_mem_ptr(this, start, end);
+
+        // targets often remap right after invalidating, so only refetch
+        // once the next access comes along
+        if (m_host->dmi_prefetch)
+            m_prefetch.push_back(range(start, end));
+    }
+
+    void master_socket::map_mmio(u64 addr, const tlm_dmi& dmi,
+                                 const mmioext& ext) {
+        const range mmio(dmi);
+        if (!mmio.includes(addr))
+            return;
+
+        unmap_mmio(mmio.start, mmio.end);
+        m_mmio[mmio.end] = { mmio, ext.addr - addr + mmio.start, ext.socket };
+    }
+
+    void master_socket::unmap_mmio(u64 start, u64 end) {
+        auto it = m_mmio.lower_bound(start);
+        while (it != m_mmio.end() && it->second.addr.start <= end)
+            it = m_mmio.erase(it);
+    }
+
+    bool master_socket::transport_mmio(tlm_generic_payload& tx, sc_time& dt) {
+        if (m_mmio.empty())
+            return false;
+
+        const range addr(tx);
+        auto it = m_mmio.lower_bound(addr.start);
+        if (it == m_mmio.end() || !addr.inside(it->second.addr))
+            return false;
+
+        // the handle may get invalidated during the call, so copy it first
+        const mmio_handle handle = it->second;
+        const u64 orig = tx.get_address();
+
+        tx.set_address(orig - handle.addr.start + handle.offset);
+        handle.socket->b_transport(tx, dt);
+        tx.set_address(orig);
+
+        return true;
+    }
+
+    void master_socket::tlb_fill(u64 addr, const tlm_dmi& dmi) {
+        const u64 page = addr >> TLB_PAGE_BITS;
+        const range mem(page << TLB_PAGE_BITS, addr | TLB_PAGE_MASK);
+        if (!mem.inside(dmi))
+            return;
+
+        // latencies must be accounted for, so these stay on the slow path
+        tlb_entry& entry = m_tlb[page % TLB_ENTRIES];
+        entry.ptr = dmi_get_ptr(dmi, mem.start);
+        entry.rdtag = dmi.is_read_allowed() &&
+            dmi.get_read_latency() == SC_ZERO_TIME ? page : TLB_INVALID;
+        entry.wrtag = dmi.is_write_allowed() &&
+            dmi.get_write_latency() == SC_ZERO_TIME ? page : TLB_INVALID;
+    }
+
+    void master_socket::tlb_flush(u64 start, u64 end) {
+        const u64 first = start >> TLB_PAGE_BITS;
+        const u64 last = end >> TLB_PAGE_BITS;
+        if (last - first >= TLB_ENTRIES) {
+            tlb_flush();
+            return;
+        }
+
+        for (u64 page = first; page <= last; page++) {
+            tlb_entry& entry = m_tlb[page % TLB_ENTRIES];
+            if (entry.rdtag == page || entry.wrtag == page) {
+                entry.rdtag = TLB_INVALID;
+                entry.wrtag = TLB_INVALID;
+            }
+        }
+    }
+
+    void master_socket::tlb_flush() {
+        for (tlb_entry& entry : m_tlb) {
+            entry.rdtag = TLB_INVALID;
+            entry.wrtag = TLB_INVALID;
+            entry.ptr = nullptr;
+        }
     }
 
     master_socket::master_socket(const char* nm, component* host):
         simple_initiator_socket<master_socket, 64>(nm),
+        m_tlb(),
         m_free(true),
         m_free_ev(concat(nm, "_free").c_str()),
         m_tx(),
@@ -35,7 +118,9 @@ namespace vcml {
         m_sbi(SBI_NONE),
         m_dmi_cache(),
         m_adapter(nullptr),
-        m_host(host) {
+        m_host(host),
+        m_prefetch(),
+        m_mmio() {
         if (m_host == nullptr) {
             m_host = dynamic_cast<component*>(get_parent_object());
             VCML_ERROR_ON(!m_host, "socket '%s' declared outside module", nm);
@@ -45,7 +130,11 @@ namespace vcml {
         register_invalidate_direct_mem_ptr(this,
                 &master_socket::invalidate_direct_mem_ptr);
 
+        tlb_flush();
+
         m_tx.set_extension(new sbiext());
+        m_tx.set_extension(new mmioext());
+        m_tx.set_extension(new atomicext());
         m_txd.set_extension(new sbiext());
     }
 
@@ -54,8 +143,51 @@ namespace vcml {
             delete m_adapter;
     }
 
+    void master_socket::end_of_elaboration() {
+        simple_initiator_socket<master_socket, 64>::end_of_elaboration();
+        if (m_host->dmi_prefetch)
+            prefetch_dmi();
+    }
+
+    void master_socket::prefetch_dmi(u64 start, u64 end) {
+        if (!m_host->allow_dmi)
+            return;
+
+        // targets report the extent of granted and denied DMI regions, so
+        // the address space can be walked one region at a time
+        u8 data = 0;
+        u64 addr = start;
+        while (addr <= end) {
+            tlm_dmi dmi;
+            tx_setup(m_txd, TLM_READ_COMMAND, addr, &data, sizeof(data));
+            tx_set_sbi(m_txd, m_sbi);
+
+            bool use_dmi = (*this)->get_direct_mem_ptr(m_txd, dmi);
+            if (dmi.get_start_address() > addr ||
+                dmi.get_end_address() < addr)
+                break;
+
+            if (use_dmi)
+                map_dmi(dmi);
+
+            if (dmi.get_end_address() >= end)
+                break;
+
+            addr = dmi.get_end_address() + 1;
+        }
+    }
+
     unsigned int master_socket::send(tlm_generic_payload& tx,
                                      const sideband& info) try {
+        if (thctl_is_worker_thread()) {
+            unsigned int bytes = 0;
+            thctl_current_worker()->request([&]() {
+                bytes = send(tx, info);
+            });
+            return bytes;
+        }
+
+        bool           mmio  = false;
         unsigned int   bytes = 0;
         unsigned int   size  = tx.get_data_length();
         unsigned int   width = tx.get_streaming_width();
@@ -92,7 +224,10 @@ namespace vcml {
             sc_time local = sc_time_stamp() + offset;
 
             trace_fw(tx, offset);
-            (*this)->b_transport(tx, offset);
+            if (m_host->allow_dmi && !info.is_nodmi)
+                mmio = transport_mmio(tx, offset);
+            if (!mmio)
+                (*this)->b_transport(tx, offset);
             trace_bw(tx, offset);
 
             sc_time now = sc_time_stamp() + offset;
@@ -106,10 +241,16 @@ namespace vcml {
         if (info.is_excl && !tx_is_excl(tx))
             bytes = 0;
 
-        if (m_host->allow_dmi && tx.is_dmi_allowed()) {
+        if (m_host->allow_dmi && tx.is_dmi_allowed() && !mmio) {
             tlm_dmi dmi;
+            mmioext* ext = tx.get_extension<mmioext>();
+            if (ext != nullptr)
+                ext->socket = nullptr;
+
             if ((*this)->get_direct_mem_ptr(tx, dmi))
                 map_dmi(dmi);
+            else if (ext != nullptr && ext->socket != nullptr)
+                map_mmio(tx.get_address(), dmi, *ext);
         }
 
         return bytes;
@@ -131,6 +272,9 @@ namespace vcml {
         if (!m_dmi_cache.lookup(addr, size, elevate, dmi))
             return TLM_INCOMPLETE_RESPONSE;
 
+        if (!info.is_debug)
+            tlb_fill(addr, dmi);
+
         if (info.is_sync && !info.is_debug)
             m_host->sync();
 
@@ -152,6 +296,108 @@ namespace vcml {
         return TLM_OK_RESPONSE;
     }
 
+    tlm_response_status master_socket::atomic_dmi(vcml_atomic_op op, u64 addr,
+                                                  void* data, unsigned int size,
+                                                  u64 compare,
+                                                  const sideband& info) {
+        if (info.is_nodmi || info.is_excl)
+            return TLM_INCOMPLETE_RESPONSE;
+
+        // write permission is needed, but the old value gets read as well
+        tlm_dmi dmi;
+        if (!m_dmi_cache.lookup(addr, size, TLM_WRITE_COMMAND, dmi) ||
+            !dmi.is_read_allowed())
+            return TLM_INCOMPLETE_RESPONSE;
+
+        unsigned char* ptr = dmi_get_ptr(dmi, addr);
+        if ((std::uintptr_t)ptr & (size - 1))
+            return TLM_INCOMPLETE_RESPONSE;
+
+        if (info.is_sync && !info.is_debug)
+            m_host->sync();
+
+        atomic_execute(op, ptr, data, size, compare);
+
+        if (!info.is_debug) {
+            m_host->local_time() += dmi.get_read_latency();
+            m_host->local_time() += dmi.get_write_latency();
+            if (info.is_sync)
+                m_host->sync();
+        }
+
+        return TLM_OK_RESPONSE;
+    }
+
+    // resets the atomic extension of a reused payload, even if the target
+    // throws, so that later plain writes do not turn into atomics
+    struct atomic_guard {
+        atomicext* ext;
+
+        atomic_guard(atomicext* e, vcml_atomic_op op, u64 compare): ext(e) {
+            ext->op = op;
+            ext->compare = compare;
+            ext->ack = false;
+        }
+
+        ~atomic_guard() {
+            ext->op = VCML_ATOMIC_NONE;
+            ext->compare = 0;
+            ext->ack = false;
+        }
+    };
+
+    tlm_response_status master_socket::atomic(vcml_atomic_op op, u64 addr,
+                                              void* data, unsigned int size,
+                                              u64 compare,
+                                              const sideband& info) {
+        VCML_ERROR_ON(op == VCML_ATOMIC_NONE, "invalid atomic operation");
+        if (!atomic_supported(addr, size))
+            return TLM_GENERIC_ERROR_RESPONSE;
+
+        if (thctl_is_worker_thread()) {
+            tlm_response_status rs = TLM_INCOMPLETE_RESPONSE;
+            thctl_current_worker()->request([&]() {
+                rs = atomic(op, addr, data, size, compare, info);
+            });
+            return rs;
+        }
+
+        if (!info.is_debug && !is_thread())
+            VCML_ERROR("non-debug TLM access outside SC_THREAD forbidden");
+
+        tlm_response_status rs = TLM_INCOMPLETE_RESPONSE;
+        if (m_host->allow_dmi)
+            rs = atomic_dmi(op, addr, data, size, compare, info);
+
+        // otherwise the target executes it, passing its exclusive monitor
+        if (rs == TLM_INCOMPLETE_RESPONSE) {
+            tlm_generic_payload& tx = m_tx;
+            atomic_guard guard(tx.get_extension<atomicext>(), op, compare);
+
+            // targets that do not know the extension would perform a plain
+            // store, so probe first using a debug ignore command
+            tx_setup(tx, TLM_IGNORE_COMMAND, addr, data, size);
+            send(tx, info | SBI_DEBUG);
+
+            if (guard.ext->ack) {
+                guard.ext->ack = false;
+                tx_setup(tx, TLM_WRITE_COMMAND, addr, data, size);
+                send(tx, info);
+                rs = tx.get_response_status();
+            } else {
+                m_host->log_warn("target at 0x%016llx does not support "
+                                 "atomic %s", addr, atomic_op_to_str(op));
+                rs = TLM_COMMAND_ERROR_RESPONSE;
+            }
+        }
+
+        if (rs == TLM_INCOMPLETE_RESPONSE)
+            m_host->log_warn("got incomplete response from target at "
+                             "0x%016llx", addr);
+
+        return rs;
+    }
+
     tlm_response_status master_socket::access(tlm_command cmd, u64 addr,
                                               void* data, unsigned int size,
                                               const sideband& info,
@@ -159,10 +405,26 @@ namespace vcml {
 
         tlm_response_status rs = TLM_INCOMPLETE_RESPONSE;
 
+        // parallel processors only use the TLB directly, anything else
+        // gets handed back to their SC_THREAD for execution
+        if (thctl_is_worker_thread()) {
+            thctl_current_worker()->request([&]() {
+                rs = access(cmd, addr, data, size, info, bytes);
+            });
+            return rs;
+        }
+
         // TLM protocol sanity checking
         if (!info.is_debug && !is_thread())
             VCML_ERROR("non-debug TLM access outside SC_THREAD forbidden");
 
+        // refetch DMI regions that got invalidated since the last access
+        while (!m_prefetch.empty()) {
+            range r = m_prefetch.back();
+            m_prefetch.pop_back();
+            prefetch_dmi(r.start, r.end);
+        }
+
         // check if we are allowed to do a DMI access on that address
         if ((cmd != TLM_IGNORE_COMMAND) && (m_host->allow_dmi))
             rs = access_dmi(cmd, addr, data, size, info);
@@ -180,7 +442,8 @@ namespace vcml {
         }
 
         if (rs == TLM_INCOMPLETE_RESPONSE)
-            log_warn("got incomplete response from target at 0x%016llx", addr);
+            m_host->log_warn("got incomplete response from target at "
+                             "0x%016llx", addr);
 
         if (bytes != nullptr)
             *bytes = size;
@@ -511,7 +511,7 @@ namespace vcml { namespace arm {
         IIDR.sync_never();
         IIDR.allow_read();
 
-        ISENABLER_PPI.set_banked();
+        ISENABLER_PPI.set_banked(true, NCPU);
         ISENABLER_PPI.sync_always();
         ISENABLER_PPI.allow_read_write();
         ISENABLER_PPI.read = &distif::read_ISENABLER_PPI;
@@ -522,7 +522,7 @@ namespace vcml { namespace arm {
         ISENABLER_SPI.tagged_read = &distif::read_ISENABLER_SPI;
         ISENABLER_SPI.tagged_write = &distif::write_ISENABLER_SPI;
 
-        ICENABLER_PPI.set_banked();
+        ICENABLER_PPI.set_banked(true, NCPU);
         ICENABLER_PPI.sync_always();
         ICENABLER_PPI.allow_read_write();
         ICENABLER_PPI.read = &distif::read_ICENABLER_PPI;
@@ -533,7 +533,7 @@ namespace vcml { namespace arm {
         ICENABLER_SPI.tagged_read = &distif::read_ICENABLER_SPI;
         ICENABLER_SPI.tagged_write = &distif::write_ICENABLER_SPI;
 
-        ISPENDR_PPI.set_banked();
+        ISPENDR_PPI.set_banked(true, NCPU);
         ISPENDR_PPI.sync_always();
         ISPENDR_PPI.allow_read_write();
         ISPENDR_PPI.read = &distif::read_ISPENDR_PPI;
@@ -544,7 +544,7 @@ namespace vcml { namespace arm {
         ISPENDR_SPI.tagged_read = &distif::read_SSPR;
         ISPENDR_SPI.tagged_write = &distif::write_SSPR;
 
-        ICPENDR_PPI.set_banked();
+        ICPENDR_PPI.set_banked(true, NCPU);
         ICPENDR_PPI.sync_always();
         ICPENDR_PPI.allow_read_write();
         ICPENDR_PPI.read = &distif::read_ICPENDR_PPI;
@@ -555,7 +555,7 @@ namespace vcml { namespace arm {
         ICPENDR_SPI.tagged_read = &distif::read_ICPENDR_SPI;
         ICPENDR_SPI.tagged_write = &distif::write_ICPENDR_SPI;
 
-        ISACTIVER_PPI.set_banked();
+        ISACTIVER_PPI.set_banked(true, NCPU);
         ISACTIVER_PPI.allow_read();
         ISACTIVER_PPI.sync_on_read();
         ISACTIVER_PPI.read = &distif::read_ISACTIVER_PPI;
@@ -564,7 +564,7 @@ namespace vcml { namespace arm {
         ISACTIVER_SPI.sync_on_read();
         ISACTIVER_SPI.tagged_read = &distif::read_ISACTIVER_SPI;
 
-        ICACTIVER_PPI.set_banked();
+        ICACTIVER_PPI.set_banked(true, NCPU);
         ICACTIVER_PPI.sync_on_write();
         ICACTIVER_PPI.allow_read_write();
         ICACTIVER_PPI.write = &distif::write_ICACTIVER_PPI;
@@ -573,18 +573,18 @@ namespace vcml { namespace arm {
         ICACTIVER_SPI.allow_read_write();
         ICACTIVER_SPI.tagged_write = &distif::write_ICACTIVER_SPI;
 
-        IPRIORITY_SGI.set_banked();
+        IPRIORITY_SGI.set_banked(true, NCPU);
         IPRIORITY_SGI.sync_never();
         IPRIORITY_SGI.allow_read_write();
 
-        IPRIORITY_PPI.set_banked();
+        IPRIORITY_PPI.set_banked(true, NCPU);
         IPRIORITY_PPI.sync_never();
         IPRIORITY_PPI.allow_read_write();
 
         IPRIORITY_SGI.sync_never();
         IPRIORITY_SGI.allow_read_write();
 
-        ITARGETS_PPI.set_banked();
+        ITARGETS_PPI.set_banked(true, NCPU);
         ITARGETS_PPI.sync_always();
         ITARGETS_PPI.allow_read_write();
         ITARGETS_PPI.tagged_read = &distif::read_ITARGETS_PPI;
@@ -603,17 +603,17 @@ namespace vcml { namespace arm {
         ICFGR_SPI.allow_read_write();
         ICFGR_SPI.tagged_write = &distif::write_ICFGR_SPI;
 
-        SGIR.set_banked();
+        SGIR.set_banked(true, NCPU);
         SGIR.allow_write();
         SGIR.sync_on_write();
         SGIR.write = &distif::write_SGIR;
 
-        SPENDSGIR.set_banked();
+        SPENDSGIR.set_banked(true, NCPU);
         SPENDSGIR.sync_always();
         SPENDSGIR.allow_read_write();
         SPENDSGIR.tagged_write = &distif::write_SPENDSGIR;
 
-        CPENDSGIR.set_banked();
+        CPENDSGIR.set_banked(true, NCPU);
         CPENDSGIR.sync_always();
         CPENDSGIR.allow_read_write();
         CPENDSGIR.tagged_write = &distif::write_CPENDSGIR;
@@ -776,40 +776,40 @@ namespace vcml { namespace arm {
         IN("IN") {
         VCML_ERROR_ON(!m_parent, "gic400 parent module not found");
 
-        CTLR.set_banked();
+        CTLR.set_banked(true, NCPU);
         CTLR.sync_always();
         CTLR.allow_read_write();
         CTLR.write = &cpuif::write_CTLR;
 
-        PMR.set_banked();
+        PMR.set_banked(true, NCPU);
         PMR.sync_always();
         PMR.allow_read_write();
         PMR.write = &cpuif::write_PMR;
 
-        BPR.set_banked();
+        BPR.set_banked(true, NCPU);
         BPR.sync_always();
         BPR.allow_read_write();
         BPR.write = &cpuif::write_BPR;
 
-        IAR.set_banked();
+        IAR.set_banked(true, NCPU);
         IAR.allow_read();
         IAR.sync_on_read();
         IAR.read = &cpuif::read_IAR;
 
-        EOIR.set_banked();
+        EOIR.set_banked(true, NCPU);
         EOIR.allow_write();
         EOIR.sync_on_write();
         EOIR.write = &cpuif::write_EOIR;
 
-        RPR.set_banked();
+        RPR.set_banked(true, NCPU);
         RPR.sync_never();
         RPR.allow_read();
 
-        HPPIR.set_banked();
+        HPPIR.set_banked(true, NCPU);
         HPPIR.sync_never();
         HPPIR.allow_read();
 
-        ABPR.set_banked();
+        ABPR.set_banked(true, NCPU);
         ABPR.sync_always();
         ABPR.allow_read_write();
 
@@ -822,7 +822,7 @@ namespace vcml { namespace arm {
         CIDR.sync_never();
         CIDR.allow_read();
 
-        DIR.set_banked();
+        DIR.set_banked(true, NCPU);
         DIR.sync_always();
         DIR.allow_read_write();
 
@@ -983,14 +983,14 @@ namespace vcml { namespace arm {
         LR("LR", 0x100, 0x0),
         IN("IN") {
 
-        HCR.set_banked();
+        HCR.set_banked(true, NCPU);
         HCR.allow_read_write();
         HCR.write = &vifctrl::write_HCR;
 
         VTR.allow_read();
         VTR.read = &vifctrl::read_VTR;
 
-        LR.set_banked();
+        LR.set_banked(true, NCPU);
         LR.allow_read_write();
         LR.tagged_write = &vifctrl::write_LR;
         LR.tagged_read = &vifctrl::read_LR;
@@ -999,7 +999,7 @@ namespace vcml { namespace arm {
         VMCR.read = &vifctrl::read_VMCR;
         VMCR.write = &vifctrl::write_VMCR;
 
-        APR.set_banked();
+        APR.set_banked(true, NCPU);
         APR.allow_read_write();
         APR.write = &vifctrl::write_APR;
     }
@@ -1096,31 +1096,31 @@ namespace vcml { namespace arm {
         IIDR("IIDR", 0xFC, IFID),
         IN("IN") {
 
-        CTLR.set_banked();
+        CTLR.set_banked(true, NCPU);
         CTLR.allow_read_write();
         CTLR.write = &vcpuif::write_CTLR;
 
-        PMR.set_banked();
+        PMR.set_banked(true, NCPU);
         PMR.allow_read_write();
 
-        BPR.set_banked();
+        BPR.set_banked(true, NCPU);
         BPR.allow_read_write();
         BPR.write = &vcpuif::write_BPR;
 
-        IAR.set_banked();
+        IAR.set_banked(true, NCPU);
         IAR.allow_read();
         IAR.read = &vcpuif::read_IAR;
 
-        EOIR.set_banked();
+        EOIR.set_banked(true, NCPU);
         EOIR.allow_write();
         EOIR.write = &vcpuif::write_EOIR;
 
-        RPR.set_banked();
+        RPR.set_banked(true, NCPU);
 
-        HPPIR.set_banked();
+        HPPIR.set_banked(true, NCPU);
         HPPIR.allow_read_write();
 
-        APR.set_banked();
+        APR.set_banked(true, NCPU);
         APR.allow_read_write();
 
         IIDR.allow_read();
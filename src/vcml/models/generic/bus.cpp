@@ -17,6 +17,7 @@
  ******************************************************************************/
 
 #include "vcml/models/generic/bus.h"
+#include "vcml/slave_socket.h"
 
 namespace vcml { namespace generic {
 
@@ -25,7 +26,7 @@ namespace vcml { namespace generic {
         #define HEX(x) std::setfill('0') << std::setw((x) > ~0u ? 16 : 8) << \
                        std::hex << (x) << std::dec
 
-        vector<mapping> mappings(m_mappings);
+        vector<mapping> mappings(m_bound);
         std::sort(mappings.begin(), mappings.end(),
                 [](const mapping& a, const mapping& b) -> bool {
             return a.addr.start < b.addr.start;
@@ -52,6 +53,8 @@ namespace vcml { namespace generic {
                 os << m_default.peer;
         }
 
+        os << std::endl << "filtered DMI invalidations: " << m_dmi_filtered;
+
         #undef HEX
         return true;
     }
@@ -62,6 +65,9 @@ namespace vcml { namespace generic {
     bus::target_socket* bus::create_target_socket(unsigned int idx) {
         hierarchy_push();
 
+        if (idx >= m_routes.size())
+            m_routes.resize(idx + 1, ~0ul);
+
         string name = "IN" + to_string(idx);
         tsock* sock = new tsock(name.c_str());
 
@@ -112,15 +118,15 @@ namespace vcml { namespace generic {
     }
 
     void bus::b_transport(int port, tlm_generic_payload& tx, sc_time& dt) {
-        const mapping& dest = lookup(tx);
-        if (dest.port == -1) {
+        const route dest = decode(port, tx);
+        if (dest.socket == nullptr) {
             tx.set_response_status(TLM_ADDRESS_ERROR_RESPONSE);
             return;
         }
 
         u64 addr = tx.get_address();
         tx.set_address(addr - dest.addr.start + dest.offset);
-        auto& socket = OUT[dest.port];
+        auto& socket = *dest.socket;
 
 
         trace_fw(socket, tx, dt);
@@ -131,78 +137,256 @@ namespace vcml { namespace generic {
     }
 
     unsigned int bus::transport_dbg(int port, tlm_generic_payload& tx) {
-        const mapping& dest = lookup(tx);
-        if (dest.port == -1) {
+        const route dest = decode(port, tx);
+        if (dest.socket == nullptr) {
             tx.set_response_status(TLM_ADDRESS_ERROR_RESPONSE);
             return 0;
         }
 
         u64 addr = tx.get_address();
         tx.set_address(addr - dest.addr.start + dest.offset);
-        unsigned int response = OUT[dest.port]->transport_dbg(tx);
+        unsigned int response = (*dest.socket)->transport_dbg(tx);
         tx.set_address(addr);
         return response;
     }
 
     bool bus::get_direct_mem_ptr(int port, tlm_generic_payload& tx,
                             tlm_dmi& dmi) {
-        const mapping& dest = lookup(tx);
-        if (dest.port == -1) {
+        const route dest = decode(port, tx);
+        if (dest.socket == nullptr) {
             tx.set_response_status(TLM_ADDRESS_ERROR_RESPONSE);
+            dmi.set_start_address(dest.addr.start);
+            dmi.set_end_address(dest.addr.end);
             return false;
         }
 
         u64 addr = tx.get_address();
         tx.set_address(addr - dest.addr.start + dest.offset);
-        bool use_dmi = OUT[dest.port]->get_direct_mem_ptr(tx, dmi);
+        bool use_dmi = (*dest.socket)->get_direct_mem_ptr(tx, dmi);
         tx.set_address(addr);
 
-        if (use_dmi) {
-            u64 s = dmi.get_start_address() + dest.addr.start - dest.offset;
-            u64 e = dmi.get_end_address() + dest.addr.start - dest.offset;
-
-            // check if target gave more DMI space than it has address space
-            if (s < dest.addr.start) {
-                log_warning("truncating DMI start from 0x%016lx to 0x%016lx",
-                            s, dest.addr.start);
-                s = dest.addr.start;
+        if (!use_dmi) {
+            // report the denied range as seen from this side of the bus
+            u64 lo = dest.offset;
+            u64 hi = dest.offset + dest.addr.end - dest.addr.start;
+            u64 s = max<u64>(dmi.get_start_address(), lo);
+            u64 e = min<u64>(dmi.get_end_address(), hi);
+            if (s > e) {
+                s = lo;
+                e = hi;
             }
 
-            if (e > dest.addr.end) {
-                log_warning("truncating DMI end from 0x%016lx to 0x%016lx",
-                            e, dest.addr.end);
-                e = dest.addr.end;
+            dmi.set_start_address(s - lo + dest.addr.start);
+            dmi.set_end_address(e - lo + dest.addr.start);
+
+            // track MMIO handles, so that their invalidation gets through
+            if (port >= 0 && tx_get_mmio(tx) != nullptr) {
+                tlm_dmi grant(dmi);
+                grant.allow_none();
+                m_dmi_grants[port].insert(grant);
             }
 
-            dmi.set_start_address(s);
-            dmi.set_end_address(e);
+            return false;
+        }
+
+        u64 s = dmi.get_start_address() + dest.addr.start - dest.offset;
+        u64 e = dmi.get_end_address() + dest.addr.start - dest.offset;
+
+        // check if target gave more DMI space than it has address space
+        if (s < dest.addr.start) {
+            log_warning("truncating DMI start from 0x%016lx to 0x%016lx",
+                        s, dest.addr.start);
+            s = dest.addr.start;
+        }
+
+        if (e > dest.addr.end) {
+            log_warning("truncating DMI end from 0x%016lx to 0x%016lx",
+                        e, dest.addr.end);
+            e = dest.addr.end;
         }
 
-        return use_dmi;
+        dmi.set_start_address(s);
+        dmi.set_end_address(e);
+
+        if (port >= 0)
+            m_dmi_grants[port].insert(dmi);
+
+        return true;
     }
 
     void bus::invalidate_direct_mem_ptr(int port, sc_dt::uint64 start,
                                                sc_dt::uint64 end) {
-        for (unsigned int i = 0; i < m_mappings.size(); i++) {
-            const mapping& m = m_mappings[i];
-            if (m.port == port) {
-                u64 s = m.addr.start + start - m.offset;
-                u64 e = m.addr.start + end - m.offset;
-
-                bus_ports<tlm_target_socket<64> >::iterator it;
-                for (it = IN.begin(); it != IN.end(); it++)
-                    (*it->second)->invalidate_direct_mem_ptr(s, e);
+        for (const mapping& m : m_bound)
+            if (m.port == port)
+                invalidate_dmi_grants(m, start, end);
+
+        if (m_default.port != -1 && m_default.port == port)
+            invalidate_dmi_grants(m_default, start, end);
+    }
+
+    void bus::invalidate_dmi_grants(const mapping& m, u64 start, u64 end) {
+        // clip to the mapped window first, targets may invalidate all of
+        // their address space at once
+        start = max(start, m.offset);
+        end = min(end, m.offset + m.addr.end - m.addr.start);
+        if (start > end)
+            return;
+
+        u64 s = m.addr.start + start - m.offset;
+        u64 e = m.addr.start + end - m.offset;
+
+        for (auto it : IN) {
+            auto grants = m_dmi_grants.find(it.first);
+            if (grants != m_dmi_grants.end() &&
+                grants->second.overlaps(range(s, e))) {
+                grants->second.invalidate(s, e);
+            } else if (!stl_contains(m_upstream_ports, it.first)) {
+                m_dmi_filtered++;
+                continue;
+            }
+
+            (*it.second)->invalidate_direct_mem_ptr(s, e);
+        }
+    }
+
+    // limits how many nested buses get flattened, also guards against loops
+    static const unsigned int BUS_MAX_DEPTH = 8;
+
+    static void find_buses(const std::vector<sc_object*>& objs,
+                           vector<bus*>& buses) {
+        for (sc_object* obj : objs) {
+            bus* b = dynamic_cast<bus*>(obj);
+            if (b != nullptr && typeid(*b) == typeid(bus))
+                buses.push_back(b);
+            find_buses(obj->get_child_objects(), buses);
+        }
+    }
+
+    void bus::invalidate_routes(unsigned int depth) {
+        m_dirty = true;
+        if (depth < BUS_MAX_DEPTH) {
+            for (bus* b : m_upstream)
+                b->invalidate_routes(depth + 1);
+        }
+    }
+
+    void bus::update_routes() {
+        m_decode.clear();
+        for (const mapping& m : m_mappings)
+            forward(m, m.addr, m.addr.start, m_decode, 0);
+        m_dirty = false;
+    }
+
+    void bus::flatten(const range& up, u64 lo, vector<route>& routes,
+                      unsigned int depth) {
+        u64 hi = lo + (up.end - up.start);
+        u64 pos = lo;
+
+        auto it = std::upper_bound(m_mappings.begin(), m_mappings.end(), lo,
+                [](u64 start, const mapping& m) -> bool {
+            return start < m.addr.start;
+        });
+
+        if (it != m_mappings.begin())
+            it--;
+
+        for (; it != m_mappings.end() && it->addr.start <= hi; it++) {
+            if (it->addr.end < pos)
+                continue;
+
+            u64 s = max(it->addr.start, pos);
+            u64 e = min(it->addr.end, hi);
+
+            if (pos < s) {
+                range gap(pos - lo + up.start, s - 1 - lo + up.start);
+                if (m_default.port == -1)
+                    routes.push_back({ gap, pos, nullptr });
+                else
+                    forward(m_default, gap, pos, routes, depth);
             }
+
+            forward(*it, range(s - lo + up.start, e - lo + up.start), s,
+                    routes, depth);
+
+            if (e == hi)
+                return;
+
+            pos = e + 1;
+        }
+
+        range gap(pos - lo + up.start, up.end);
+        if (m_default.port == -1)
+            routes.push_back({ gap, pos, nullptr });
+        else
+            forward(m_default, gap, pos, routes, depth);
+    }
+
+    void bus::forward(const mapping& m, const range& up, u64 lo,
+                      vector<route>& routes, unsigned int depth) {
+        u64 dest = lo - m.addr.start + m.offset;
+
+        auto it = m_downstream.find(m.port);
+        if (it != m_downstream.end() && depth < BUS_MAX_DEPTH) {
+            it->second->flatten(up, dest, routes, depth + 1);
+            return;
         }
+
+        routes.push_back({ up, dest, &OUT[m.port] });
+    }
+
+    bus::route bus::decode(int port, const range& addr) {
+        if (m_dirty)
+            update_routes();
+
+        // routes never overlap, so a cached route is valid whenever it
+        // still includes addr, even if the routes got rebuilt meanwhile
+        if (port >= 0 && (size_t)port < m_routes.size()) {
+            size_t idx = m_routes[port];
+            if (idx < m_decode.size() && m_decode[idx].addr.includes(addr))
+                return m_decode[idx];
+        }
+
+        auto next = std::upper_bound(m_decode.begin(), m_decode.end(),
+                addr.start, [](u64 start, const route& r) -> bool {
+            return start < r.addr.start;
+        });
+
+        if (next != m_decode.begin() && (next - 1)->addr.includes(addr)) {
+            if (port >= 0 && (size_t)port < m_routes.size())
+                m_routes[port] = next - 1 - m_decode.begin();
+            return *(next - 1);
+        }
+
+        // accesses that cross the boundary of a flattened route take the
+        // regular path through the next bus, which then reports the error
+        const mapping& m = lookup(addr);
+        if (m.port != -1)
+            return { m.addr, m.offset, &OUT[m.port] };
+
+        // report the unmapped gap around addr, e.g. for DMI denial
+        u64 lo = next != m_decode.begin() ? (next - 1)->addr.end + 1 : 0;
+        u64 hi = next != m_decode.end() ? next->addr.start - 1 : ~0ull;
+        return { range(min(lo, addr.start), max(hi, addr.start)), 0, nullptr };
     }
 
     const bus::mapping& bus::lookup(const range& addr) const {
-        for (unsigned int i = 0; i < m_mappings.size(); i++) {
-            const mapping& m = m_mappings[i];
-            if (m.addr.includes(addr))
-                return m;
+        // overlapping mappings are resolved in bind order, so that accesses
+        // spanning several clipped pieces still reach their original target
+        if (m_overlaps) {
+            for (const mapping& m : m_bound)
+                if (m.addr.includes(addr))
+                    return m;
+            return m_default;
         }
 
+        auto it = std::upper_bound(m_mappings.begin(), m_mappings.end(),
+                addr.start, [](u64 start, const mapping& m) -> bool {
+            return start < m.addr.start;
+        });
+
+        if (it != m_mappings.begin() && (--it)->addr.includes(addr))
+            return *it;
+
         return m_default;
     }
 
@@ -223,7 +407,43 @@ namespace vcml { namespace generic {
             .peer = peer,
         };
 
-        m_mappings.push_back(mapping);
+        m_bound.push_back(mapping);
+
+        auto it = std::upper_bound(m_mappings.begin(), m_mappings.end(),
+                addr.start, [](u64 start, const struct mapping& m) -> bool {
+            return start < m.addr.start;
+        });
+
+        if (it != m_mappings.begin() && (it - 1)->addr.overlaps(addr))
+            it--;
+
+        // earlier mappings keep priority on partial overlaps, so only the
+        // parts of addr that are still unmapped get inserted
+        u64 pos = addr.start;
+        while (true) {
+            if (it != m_mappings.end() && it->addr.start <= pos) {
+                m_overlaps = true;
+                if (it->addr.end >= addr.end)
+                    break;
+                pos = it->addr.end + 1;
+                it++;
+                continue;
+            }
+
+            u64 end = addr.end;
+            if (it != m_mappings.end() && it->addr.start <= addr.end)
+                end = it->addr.start - 1;
+
+            mapping.addr = range(pos, end);
+            mapping.offset = offset + pos - addr.start;
+            it = m_mappings.insert(it, mapping) + 1;
+
+            if (end == addr.end)
+                break;
+            pos = end + 1;
+        }
+
+        invalidate_routes();
     }
 
     void bus::map(unsigned int port, u64 start, u64 end, u64 offset,
@@ -239,6 +459,8 @@ namespace vcml { namespace generic {
         m_default.addr = range(0ull, ~0ull);
         m_default.offset = offset;
         m_default.peer = peer;
+
+        invalidate_routes();
     }
 
     unsigned int bus::bind(tlm_initiator_socket<64>& socket) {
@@ -277,7 +499,17 @@ namespace vcml { namespace generic {
     bus::bus(const sc_module_name& nm):
         component(nm),
         m_mappings(),
+        m_bound(),
+        m_overlaps(false),
         m_default(),
+        m_decode(),
+        m_routes(),
+        m_dirty(true),
+        m_downstream(),
+        m_upstream(),
+        m_dmi_grants(),
+        m_upstream_ports(),
+        m_dmi_filtered(0),
         IN(this),
         OUT(this) {
 
@@ -294,6 +526,31 @@ namespace vcml { namespace generic {
         // nothing to do
     }
 
+    void bus::end_of_elaboration() {
+        component::end_of_elaboration();
+
+        vector<bus*> buses;
+        find_buses(sc_core::sc_get_top_level_objects(), buses);
+
+        for (auto out : OUT) {
+            sc_core::sc_interface* fw = out.second->get_interface();
+            for (bus* b : buses) {
+                for (auto in : b->IN) {
+                    if (in.second->get_interface() != fw)
+                        continue;
+
+                    m_downstream[out.first] = b;
+                    if (!stl_contains(b->m_upstream, this))
+                        b->m_upstream.push_back(this);
+                    if (!stl_contains(b->m_upstream_ports, in.first))
+                        b->m_upstream_ports.push_back(in.first);
+                }
+            }
+        }
+
+        invalidate_routes();
+    }
+
     template <>
     bus::target_socket*
     bus::create_socket<bus::target_socket>(unsigned int idx) {
@@ -190,4 +190,18 @@ namespace vcml { namespace generic {
         return TLM_OK_RESPONSE;
     }
 
+    tlm_response_status memory::atomic_transport(const range& addr,
+            void* data, const atomicext& ext, const sideband& info) {
+        if (addr.end >= size)
+            return TLM_ADDRESS_ERROR_RESPONSE;
+        if (readonly && !info.is_debug)
+            return TLM_COMMAND_ERROR_RESPONSE;
+        if (!atomic_supported(addr.start, addr.length()))
+            return TLM_GENERIC_ERROR_RESPONSE;
+
+        atomic_execute(ext.op, m_memory + addr.start, data, addr.length(),
+                       ext.compare);
+        return TLM_OK_RESPONSE;
+    }
+
 }}
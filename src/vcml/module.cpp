@@ -57,8 +57,14 @@ namespace vcml {
     module::module(const sc_module_name& nm):
         sc_module(nm),
         m_commands(),
+        m_trace_version(0),
+        m_trace_predicate(),
+        m_log_limiter(this),
         trace_errors("trace_errors", false),
-        loglvl("loglvl", trace_errors ? LOG_TRACE : default_log_level()) {
+        trace_filter("trace_filter", logger::trace_filter),
+        loglvl("loglvl", trace_errors ? LOG_TRACE : default_log_level()),
+        log_rate("log_rate", logger::log_rate) {
+        update_trace_predicate();
         register_command("clist", 0, this, &module::cmd_clist,
                          "returns a list of supported commands");
         register_command("cinfo", 1, this, &module::cmd_cinfo,
@@ -68,7 +74,7 @@ namespace vcml {
     }
 
     module::~module() {
-        // nothing to do
+        m_log_limiter.flush();
     }
 
     void module::session_suspend() {
@@ -96,6 +102,16 @@ namespace vcml {
         return cmd->execute(args, os);
     }
 
+    void module::update_trace_predicate() const {
+        m_trace_version = trace_filter.version();
+        m_trace_predicate.compile(trace_filter);
+    }
+
+    void module::set_trace_filter(const string& spec) {
+        trace_filter = spec;
+        update_trace_predicate();
+    }
+
     vector<command_base*> module::get_commands() const {
         vector<command_base*> list;
         for (auto cmd : m_commands)
@@ -50,6 +50,7 @@ namespace vcml {
         m_endian(endian),
         m_registers(),
         m_backends(),
+        m_registers_sorted(true),
         read_latency("read_latency", rlatency),
         write_latency("write_latency", wlatency),
         backends("backends", "null") {
@@ -77,19 +78,50 @@ namespace vcml {
             r->reset();
     }
 
-    void peripheral::add_register(reg_base* reg) {
-        if (stl_contains(m_registers, reg))
-            VCML_ERROR("register %s already assigned", reg->name());
-
-        for (auto r : m_registers)
-            if (r->get_range().overlaps(reg->get_range()))
-                VCML_ERROR("register address space already in use");
-
-        m_registers.push_back(reg);
+    void peripheral::sort_registers() {
         std::sort(m_registers.begin(), m_registers.end(),
             [] (const reg_base* a, const reg_base* b) -> bool {
                 return a->get_address() < b->get_address();
         });
+
+        for (size_t i = 1; i < m_registers.size(); i++) {
+            if (m_registers[i] == m_registers[i - 1])
+                VCML_ERROR("register %s already assigned",
+                           m_registers[i]->name());
+            if (m_registers[i]->get_range().overlaps(
+                m_registers[i - 1]->get_range()))
+                VCML_ERROR("register address space already in use");
+        }
+
+        m_registers_sorted = true;
+    }
+
+    unsigned int peripheral::clip_to_register(u64 addr, unsigned int size) {
+        if (!m_registers_sorted)
+            sort_registers();
+
+        auto it = std::lower_bound(m_registers.begin(), m_registers.end(),
+                addr, [](const reg_base* r, u64 a) -> bool {
+            return r->get_range().end < a;
+        });
+
+        if (it == m_registers.end())
+            return size;
+
+        const range& r = (*it)->get_range();
+        u64 limit = r.start <= addr ? r.end - addr + 1 : r.start - addr;
+        return (unsigned int)min<u64>(size, limit);
+    }
+
+    void peripheral::end_of_elaboration() {
+        component::end_of_elaboration();
+        if (!m_registers_sorted)
+            sort_registers();
+    }
+
+    void peripheral::add_register(reg_base* reg) {
+        m_registers.push_back(reg);
+        m_registers_sorted = false;
     }
 
     void peripheral::remove_register(reg_base* reg) {
@@ -136,6 +168,40 @@ namespace vcml {
         unsigned int be_index = 0;
         unsigned int nbytes = 0;
 
+        // atomics are executed as a whole, using read and write latency
+        atomicext* atom = tx_get_atomic(tx);
+        if (atom != nullptr) {
+            // probes only ask whether atomics are understood at all
+            if (tx.is_ignore()) {
+                atom->ack = true;
+                tx.set_response_status(TLM_OK_RESPONSE);
+                return 0;
+            }
+
+            if (!info.is_debug) {
+                local_time() += clock_cycles(read_latency);
+                local_time() += clock_cycles(write_latency);
+            }
+
+            tlm_response_status rs;
+            if (be_ptr != nullptr)
+                rs = TLM_BYTE_ENABLE_ERROR_RESPONSE;
+            else if (streaming_width != length && streaming_width != 0)
+                rs = TLM_BURST_ERROR_RESPONSE;
+            else
+                rs = atomic_transport(range(tx), ptr, *atom, info);
+
+            if (rs == TLM_INCOMPLETE_RESPONSE)
+                rs = TLM_COMMAND_ERROR_RESPONSE;
+
+            atom->ack = true;
+            tx.set_response_status(rs);
+            if (!info.is_debug && needs_sync())
+                sync();
+
+            return tx.is_response_ok() ? length : 0;
+        }
+
         if (streaming_width == 0)
             streaming_width = length;
 
@@ -151,18 +217,33 @@ namespace vcml {
                 tx.set_data_length(streaming_width);
                 nbytes += receive(tx, info);
             } else {
-                for (unsigned int byte = 0; byte < streaming_width; byte++) {
-                    if (be_ptr[be_index++ % be_length] == 0x00)
+                // forward runs of enabled bytes as a single access each
+                unsigned int byte = 0;
+                while (byte < streaming_width) {
+                    if (be_ptr[(be_index + byte) % be_length] == 0x00) {
+                        byte++;
                         continue;
+                    }
+
+                    unsigned int run = 1;
+                    while (byte + run < streaming_width &&
+                           be_ptr[(be_index + byte + run) % be_length])
+                        run++;
+
+                    run = clip_to_register(addr + byte, run);
 
                     tx.set_address(addr + byte);
                     tx.set_data_ptr(ptr + pulse * streaming_width + byte);
-                    tx.set_data_length(1);
-                    tx.set_streaming_width(1);
+                    tx.set_data_length(run);
+                    tx.set_streaming_width(run);
                     tx.set_byte_enable_ptr(nullptr);
                     tx.set_byte_enable_length(0);
                     nbytes += receive(tx, info);
+
+                    byte += run;
                 }
+
+                be_index += streaming_width;
             }
         }
 
@@ -185,20 +266,32 @@ namespace vcml {
         unsigned int bytes = 0;
         unsigned int nregs = 0;
 
+        if (!m_registers_sorted)
+            sort_registers();
+
         set_current_cpu(info.cpuid);
 
-        for (auto reg : m_registers)
-            if (reg->get_range().overlaps(tx)) {
-                bytes += reg->receive(tx, info);
-                nregs ++;
-            }
+        // registers are sorted and disjoint, so their end addresses are
+        // sorted as well and the first candidate can be binary searched
+        const range addr(tx);
+        auto it = std::lower_bound(m_registers.begin(), m_registers.end(),
+                addr.start, [](const reg_base* r, u64 start) -> bool {
+            return r->get_range().end < start;
+        });
+
+        for (; it != m_registers.end(); it++) {
+            if ((*it)->get_range().start > addr.end)
+                break;
+
+            bytes += (*it)->receive(tx, info);
+            nregs ++;
+        }
 
         set_current_cpu(SBI_NONE.cpuid);
         if (nregs > 0) // stop if at least one register took the access
             return bytes;
 
         tlm_response_status rs = TLM_OK_RESPONSE;
-        const range addr(tx);
         if (tx.is_read())
             rs = read(addr, tx.get_data_ptr(), info);
         if (tx.is_write())
@@ -220,6 +313,11 @@ namespace vcml {
         return TLM_INCOMPLETE_RESPONSE; // to be overloaded
     }
 
+    tlm_response_status peripheral::atomic_transport(const range& addr,
+            void* data, const atomicext& ext, const sideband& info) {
+        return TLM_INCOMPLETE_RESPONSE; // to be overloaded
+    }
+
     void peripheral::handle_clock_update(clock_t oldclk, clock_t newclk) {
         const sc_time rlat = clock_cycles(read_latency);
         const sc_time wlat = clock_cycles(write_latency);
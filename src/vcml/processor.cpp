@@ -419,6 +419,104 @@ namespace vcml {
         set_cpureg(reg.regno, val);
     }
 
+    static vector<processor*> g_parallel_pending;
+    static sc_event* g_parallel_event = nullptr;
+
+    void processor::parallel_dispatcher() {
+        vector<processor*> phase;
+        phase.swap(g_parallel_pending);
+
+        for (processor* cpu : phase)
+            cpu->m_worker->resume();
+
+        // the kernel is parked until all workers have stopped, so other
+        // host threads may enter their critical sections meanwhile
+        bool critical = thctl_in_critical();
+        if (critical)
+            thctl_exit_critical();
+
+        for (processor* cpu : phase)
+            cpu->m_worker->join();
+
+        if (critical)
+            thctl_enter_critical();
+
+        for (processor* cpu : phase)
+            cpu->m_worker_ev.notify();
+    }
+
+    void processor::simulate_parallel(unsigned int cycles) {
+        m_worker->start([this, cycles]() {
+            simulate(cycles);
+        });
+
+        while (true) {
+            g_parallel_pending.push_back(this);
+            g_parallel_event->notify(SC_ZERO_TIME);
+            wait(m_worker_ev);
+
+            if (m_worker->is_done())
+                break;
+
+            m_worker->run_request();
+        }
+
+        m_worker->finish();
+    }
+
+    void processor::wait_idle() {
+        m_idle = false;
+
+        // interrupts that change while we sync would not wake us up anymore
+        u64 gen = m_irq_gen;
+        sync();
+        if (gen != m_irq_gen)
+            return;
+
+        sc_time start = sc_time_stamp();
+        sc_time cycle = clock_cycle();
+        log_debug("idle at %s", start.to_string().c_str());
+
+        // timers that are not wired to an IRQ may still end our idle time,
+        // so never sleep past the next event anybody else is waiting for
+        sc_time next = sc_time_to_pending_activity();
+        if (next < cycle)
+            next = cycle;
+
+        if (sc_pending_activity() && next != SC_ZERO_TIME)
+            wait(next, m_irq_ev | RESET.default_event() |
+                 CLOCK.default_event());
+        else
+            wait(m_irq_ev | RESET.default_event() | CLOCK.default_event());
+
+        // skipped cycles have already passed, so keep them off local time
+        if (cycle != SC_ZERO_TIME)
+            m_cycles_skipped += (sc_time_stamp() - start) / cycle;
+    }
+
+    void processor::service_irqs() {
+        for (auto& it : m_irq_stats) {
+            irq_stats& stats = it.second;
+            if (!stats.irq_pending)
+                continue;
+
+            stats.irq_pending = false;
+            stats.irq_serviced++;
+            stats.irq_latency += local_time_stamp() - stats.irq_last;
+        }
+
+        m_irq_pending = false;
+    }
+
+    sc_time processor::quantum_horizon(const sc_time& quantum) const {
+        // run until the next event anybody else is waiting for, but never
+        // shorter than the quantum and never longer than the horizon
+        sc_time next = sc_time_to_pending_activity();
+        if (next > horizon)
+            next = horizon;
+        return next > quantum ? next : quantum;
+    }
+
     void processor::processor_thread() {
         wait(SC_ZERO_TIME);
         while (true) {
@@ -428,6 +526,8 @@ namespace vcml {
             wait_clock_reset();
 
             sc_time quantum = tlm_global_quantum::instance().get();
+            if (horizon > quantum)
+                quantum = quantum_horizon(quantum);
 
             unsigned int num_cycles = 1;
             if (quantum != SC_ZERO_TIME)
@@ -435,8 +535,14 @@ namespace vcml {
             if (num_cycles == 0)
                 num_cycles = 1;
 
+            // interrupts are serviced when the processor next simulates
+            if (m_irq_pending)
+                service_irqs();
+
             double start = realtime();
-            if (m_gdb == nullptr) {
+            if (m_worker != nullptr) {
+                simulate_parallel(num_cycles);
+            } else if (m_gdb == nullptr) {
                 simulate(num_cycles);
             } else {
                 m_gdb->simulate(num_cycles);
@@ -450,6 +556,11 @@ namespace vcml {
 
             m_run_time += realtime() - start;
 
+            if (m_idle) {
+                wait_idle();
+                continue;
+            }
+
             if (needs_sync())
                 sync();
 
@@ -471,6 +582,9 @@ namespace vcml {
 
         stats.irq_status = irq_up;
 
+        stats.irq_pending = irq_up;
+        m_irq_pending |= irq_up;
+
         if (irq_up) {
             stats.irq_count++;
             stats.irq_last = sc_time_stamp();
@@ -483,6 +597,8 @@ namespace vcml {
 
         log_debug("%sing IRQ %u", irq_up ? "sett" : "clear", irq);
         interrupt(irq, irq_up);
+        m_irq_gen++;
+        m_irq_ev.notify();
     }
 
     SC_HAS_PROCESS(processor);
@@ -491,8 +607,15 @@ namespace vcml {
         component(nm),
         m_run_time(0),
         m_cycle_count(0),
+        m_cycles_skipped(0),
         m_symbols(nullptr),
         m_gdb(nullptr),
+        m_worker(nullptr),
+        m_worker_ev("worker_ev"),
+        m_idle(false),
+        m_irq_pending(false),
+        m_irq_gen(0),
+        m_irq_ev("irq_ev"),
         m_irq_stats(),
         m_endian(VCML_ENDIAN_LITTLE),
         m_cpuregs(),
@@ -502,6 +625,8 @@ namespace vcml {
         gdb_wait("gdb_wait", false),
         gdb_sync("gdb_sync", true),
         gdb_echo("gdb_echo", false),
+        parallel("parallel", false),
+        horizon("horizon", SC_ZERO_TIME),
         IRQ("IRQ"),
         INSN("INSN"),
         DATA("DATA") {
@@ -543,6 +668,8 @@ namespace vcml {
     }
 
     processor::~processor() {
+        if (m_worker)
+            delete m_worker;
         if (m_gdb)
             delete m_gdb;
         if (m_symbols)
@@ -554,7 +681,9 @@ namespace vcml {
     void processor::reset() {
         component::reset();
         m_cycle_count = 0;
+        m_cycles_skipped = 0;
         m_run_time = 0.0;
+        m_idle = false;
 
         for (auto reg : m_cpuregs)
             reg.second.reset();
@@ -657,6 +786,24 @@ namespace vcml {
     }
 
     void processor::end_of_elaboration() {
+        if (parallel && m_gdb != nullptr)
+            log_warn("parallel simulation not supported with gdb attached");
+
+        if (parallel && m_gdb == nullptr) {
+            m_worker = new thctl_worker(name());
+
+            if (g_parallel_event == nullptr) {
+                g_parallel_event = new sc_event();
+
+                sc_spawn_options opts;
+                opts.spawn_method();
+                opts.set_sensitivity(g_parallel_event);
+                opts.dont_initialize();
+                sc_spawn(&processor::parallel_dispatcher,
+                         "parallel_dispatcher", &opts);
+            }
+        }
+
         for (auto it : IRQ) {
             std::stringstream ss;
             ss << "irq_handler_" << it.first;
@@ -675,6 +822,9 @@ namespace vcml {
             stats.irq_last = SC_ZERO_TIME;
             stats.irq_uptime = SC_ZERO_TIME;
             stats.irq_longest = SC_ZERO_TIME;
+            stats.irq_pending = false;
+            stats.irq_serviced = 0;
+            stats.irq_latency = SC_ZERO_TIME;
         }
     }
 
@@ -41,7 +41,8 @@ namespace vcml {
     property_base::property_base(const char* nm, sc_module* parent):
         sc_attr_base(gen_hierarchy_name(nm, parent)),
         m_base(nm),
-        m_parent(find_parent(parent)) {
+        m_parent(find_parent(parent)),
+        m_version(0) {
         VCML_ERROR_ON(!m_parent, "property '%s' declared outside module", nm);
         m_parent->add_attribute(*this);
     }
@@ -40,6 +40,29 @@ namespace vcml {
         m_host->remove_register(this);
     }
 
+    bool reg_base::needs_swap() const {
+        return m_host->get_endian() != host_endian();
+    }
+
+    void reg_base::do_generic_access(const range& addr, unsigned char* ptr,
+                                     bool is_read, bool swap) {
+        if (swap)
+            memswap(ptr, addr.length());
+
+        if (is_read)
+            do_read(addr, ptr);
+        else
+            do_write(addr, ptr);
+
+        if (swap) // swap back
+            memswap(ptr, addr.length());
+    }
+
+    void reg_base::do_access(const range& addr, unsigned char* ptr,
+                             bool is_read) {
+        do_generic_access(addr, ptr, is_read, needs_swap());
+    }
+
     unsigned int reg_base::receive(tlm_generic_payload& tx,
                                    const sideband& info) {
         VCML_ERROR_ON(!m_range.overlaps(tx), "invalid register access");
@@ -74,16 +97,8 @@ namespace vcml {
             m_host->sync();
 
         unsigned char* ptr = tx.get_data_ptr() + addr.start - tx.get_address();
-        if (m_host->get_endian() != host_endian()) // i.e. if big endian
-            memswap(ptr, addr.length());
-
-        if (tx.is_read())
-            do_read(addr, ptr);
-        if (tx.is_write())
-            do_write(addr, ptr);
-
-        if (m_host->get_endian() != host_endian()) // i.e. swap back
-            memswap(ptr, addr.length());
+        if (tx.is_read() || tx.is_write())
+            do_access(addr, ptr, tx.is_read());
 
         tx.set_response_status(TLM_OK_RESPONSE);
 
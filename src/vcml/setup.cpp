@@ -27,7 +27,10 @@ namespace vcml {
         PRINT("  -l | --log [file]         Enable logging to <file>|stdout\n");
         PRINT("       --log-debug          Activate debug logging\n");
         PRINT("       --log-delta          Include delta cycle in logs\n");
+        PRINT("       --log-rate <n>       Log at most <n>/s per call site\n");
         PRINT("  -t | --trace [file]       Enable tracing to <file>|stdout\n");
+        PRINT("       --trace-bin <file>   Enable binary tracing to <file>\n");
+        PRINT("       --trace-filter <f>   Trace only what matches <f>\n");
         PRINT("  -f | --config-file <file> Read configuration from <file>\n");
         PRINT("  -c | --config  <x>=<y>    Set property <x> to value <y>\n");
         PRINT("  -h | --help               Print this message\n");
@@ -48,6 +51,14 @@ namespace vcml {
             } else if (!strcmp(arg, "--log-delta")) {
                 logger::print_delta_cycle = !logger::print_delta_cycle;
 
+            } else if (!strcmp(arg, "--log-rate")) {
+                if (i >= argc - 1) {
+                    PRINT("Error: %s expects <n> argument\n", arg);
+                    return false;
+                }
+
+                logger::log_rate = from_string<unsigned int>(argv[++i]);
+
             } else if (!strcmp(arg, "--log") || !strcmp(arg, "-l")) {
                 if (i >= argc - 1 || *argv[i+1] == '-')
                     m_log_stdout = !m_log_stdout;
@@ -60,6 +71,22 @@ namespace vcml {
                 else
                     stl_add_unique(m_trace_files, string(argv[++i]));
 
+            } else if (!strcmp(arg, "--trace-bin")) {
+                if (i >= argc - 1 || *argv[i+1] == '-') {
+                    PRINT("Error: %s expects <file> argument\n", arg);
+                    return false;
+                }
+
+                m_trace_binary = argv[++i];
+
+            } else if (!strcmp(arg, "--trace-filter")) {
+                if (i >= argc - 1) {
+                    PRINT("Error: %s expects <filter> argument\n", arg);
+                    return false;
+                }
+
+                logger::trace_filter = argv[++i];
+
             } else if (!strcmp(arg, "--config-file") || !strcmp(arg, "-f")) {
                 if (i >= argc - 1 || *argv[i+1] == '-') {
                     PRINT("Error: %s expects <file> argument\n", arg);
@@ -91,7 +118,9 @@ namespace vcml {
         m_log_files(),
         m_trace_files(),
         m_config_files(),
+        m_trace_binary(),
         m_loggers(),
+        m_tracer(nullptr),
         m_providers() {
         VCML_ERROR_ON(s_instance != nullptr, "setup already created");
         s_instance = this;
@@ -126,6 +155,9 @@ namespace vcml {
             m_loggers.push_back(tracer);
         }
 
+        if (!m_trace_binary.empty())
+            m_tracer = new trace_file(m_trace_binary);
+
         m_providers.push_back(new property_provider_arg(argc, argv));
         m_providers.push_back(new property_provider_env());
 
@@ -140,6 +172,8 @@ namespace vcml {
             delete provider;
         for (auto logger : m_loggers)
             delete logger;
+        if (m_tracer)
+            delete m_tracer;
     }
 
     setup* setup::instance() {
@@ -20,6 +20,17 @@
 
 namespace vcml {
 
+    tlm_extension_base* mmioext::clone() const {
+        return new mmioext(*this);
+    }
+
+    void mmioext::copy_from(const tlm_extension_base& ext) {
+        VCML_ERROR_ON(typeid(this) != typeid(ext), "cannot copy extension");
+        const mmioext& other = (const mmioext&)ext;
+        socket = other.socket;
+        addr = other.addr;
+    }
+
     void slave_socket::b_transport(tlm_generic_payload& tx, sc_time& dt) {
         trace_fw(tx, dt);
 
@@ -27,13 +38,15 @@ namespace vcml {
         while (self != m_curr)
             sc_core::wait(m_free_ev);
 
+        // revoke DMI to the entire granule, so that all stores to it reach
+        // the exclusive monitor and can clear the reservation
         if (tx_is_excl(tx) && tx.is_read()) {
-            unmap_dmi(tx.get_address(),
-                      tx.get_address() + tx.get_data_length() - 1);
+            range granule = m_exmon.align(range(tx));
+            unmap_dmi(granule.start, granule.end);
         }
 
         tlm_dmi dmi;
-        if (m_dmi_cache.lookup(tx, dmi))
+        if (m_dmi_cache.lookup(tx, dmi) || mmio_allowed(tx))
             tx.set_dmi_allowed(true);
 
         if (m_exmon.update(tx)) {
@@ -43,8 +56,9 @@ namespace vcml {
             tx.set_response_status(tlm::TLM_OK_RESPONSE);
         }
 
-        m_curr++;
-        m_free_ev.notify();
+        // only wake up other initiators if they are actually waiting
+        if (++m_curr != m_next)
+            m_free_ev.notify();
 
         trace_bw(tx, dt);
     }
@@ -59,13 +73,19 @@ namespace vcml {
         dmi.set_start_address(0);
         dmi.set_end_address((sc_dt::uint64)-1);
 
-        if (!m_dmi_cache.lookup(tx, dmi))
-            return false;
+        if (m_dmi_cache.lookup(tx, dmi) &&
+            m_host->get_direct_mem_ptr(this, tx, dmi))
+            return m_exmon.override_dmi(tx, dmi);
 
-        if (!m_host->get_direct_mem_ptr(this, tx, dmi))
-            return false;
+        // no memory to hand out, offer a handle to this socket instead
+        if (mmio_allowed(tx)) {
+            mmioext* ext = tx.get_extension<mmioext>();
+            ext->socket = this;
+            ext->addr = tx.get_address();
+            m_mmio = true;
+        }
 
-        return m_exmon.override_dmi(tx, dmi);
+        return false;
     }
 
     slave_socket::slave_socket(const char* nm, component* host):
@@ -76,12 +96,14 @@ namespace vcml {
         m_dmi_cache(),
         m_exmon(),
         m_adapter(nullptr),
-        m_host(host) {
+        m_host(host),
+        m_mmio(false) {
         if (m_host == nullptr) {
             m_host = dynamic_cast<component*>(get_parent_object());
             VCML_ERROR_ON(!m_host, "socket '%s' declared outside module", nm);
         }
 
+        m_exmon.set_granule(m_host->exmon_granule);
         m_host->register_socket(this);
         register_b_transport(this, &slave_socket::b_transport);
         register_transport_dbg(this, &slave_socket::transport_dbg);
@@ -115,6 +137,11 @@ namespace vcml {
             (*this)->invalidate_direct_mem_ptr(dmi.get_start_address(),
                                                dmi.get_end_address());
         }
+
+        if (m_mmio) {
+            m_mmio = false;
+            (*this)->invalidate_direct_mem_ptr(0, ~0ull);
+        }
     }
 
 }
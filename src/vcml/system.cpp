@@ -17,18 +17,136 @@
  ******************************************************************************/
 
 #include "vcml/system.h"
+#include "vcml/processor.h"
+#include "vcml/logging/log_writer.h"
+#include "vcml/logging/log_limiter.h"
 
 namespace vcml {
 
+    // interrupts that spend more than this fraction of simulated time
+    // waiting for their processor to run make the quantum shrink, the
+    // quantum is kept as long as they wait more than the lower fraction
+    static const double QUANTUM_IRQ_SHRINK = 0.05;
+    static const double QUANTUM_IRQ_KEEP = 0.01;
+
+    // fraction of host time spent outside processor::simulate, i.e. in the
+    // kernel and other processes, above which the quantum grows
+    static const double QUANTUM_SCHED_GROW = 0.1;
+
+    static void find_processors(sc_object* obj, vector<processor*>& cpus) {
+        processor* cpu = dynamic_cast<processor*>(obj);
+        if (cpu != nullptr)
+            cpus.push_back(cpu);
+
+        for (sc_object* child : obj->get_child_objects())
+            find_processors(child, cpus);
+    }
+
+    void system::sample_stats(double& run_time, sc_time& irq_latency) const {
+        run_time = 0.0;
+        irq_latency = SC_ZERO_TIME;
+
+        vector<processor*> cpus;
+        for (sc_object* obj : get_child_objects())
+            find_processors(obj, cpus);
+
+        for (processor* cpu : cpus) {
+            run_time += cpu->get_run_time();
+            for (auto it : cpu->IRQ) {
+                irq_stats stats;
+                if (cpu->get_irq_stats(it.first, stats))
+                    irq_latency += stats.irq_latency;
+            }
+        }
+    }
+
+    void system::tune_quantum() {
+        double now = realtime();
+        double run_time;
+        sc_time irq_latency;
+        sample_stats(run_time, irq_latency);
+
+        // processor resets restart their run time, so clamp at zero
+        double busy = max(run_time - m_run_time, 0.0);
+        double overhead = 0.0;
+        if (now > m_realtime)
+            overhead = max(1.0 - busy / (now - m_realtime), 0.0);
+
+        sc_time interval = quantum_interval.get();
+        double waiting = (irq_latency - m_irq_latency) / interval;
+
+        m_run_time = run_time;
+        m_realtime = now;
+        m_irq_latency = irq_latency;
+
+        sc_time next = m_quantum;
+        if (waiting > QUANTUM_IRQ_SHRINK)
+            next = m_quantum / 2.0;
+        else if (waiting <= QUANTUM_IRQ_KEEP && overhead > QUANTUM_SCHED_GROW)
+            next = m_quantum * 2.0;
+
+        if (next < quantum_min)
+            next = quantum_min;
+        if (next > quantum_max)
+            next = quantum_max;
+
+        if (next == m_quantum)
+            return;
+
+        log_info("changing quantum from %s to %s (%.1f%% scheduling time, "
+                 "%.1f%% irq waiting time)", m_quantum.to_string().c_str(),
+                 next.to_string().c_str(), overhead * 100.0, waiting * 100.0);
+
+        m_quantum = next;
+        tlm::tlm_global_quantum::instance().set(m_quantum);
+    }
+
+    void system::quantum_tuner() {
+        m_quantum = tlm::tlm_global_quantum::instance().get();
+        m_realtime = realtime();
+        sample_stats(m_run_time, m_irq_latency);
+
+        while (true) {
+            wait(quantum_interval);
+
+            // quantum has been set manually, e.g. via the session interface
+            sc_time current = tlm::tlm_global_quantum::instance().get();
+            if (current != m_quantum) {
+                log_info("quantum set to %s, stopping auto tuning",
+                         current.to_string().c_str());
+                return;
+            }
+
+            tune_quantum();
+        }
+    }
+
+    SC_HAS_PROCESS(system);
+
     system::system(const sc_module_name& nm):
         module(nm),
+        m_quantum(),
+        m_run_time(0.0),
+        m_realtime(0.0),
+        m_irq_latency(),
         name("name", progname()),
         desc("desc", progname()),
         backtrace("backtrace", true),
         session("session", 0),
         session_debug("session_debug", false),
         quantum("quantum", sc_time(1, SC_US)),
-        duration("duration", SC_ZERO_TIME) {
+        duration("duration", SC_ZERO_TIME),
+        quantum_auto("quantum_auto", false),
+        quantum_min("quantum_min", sc_time(100, SC_NS)),
+        quantum_max("quantum_max", sc_time(100, SC_US)),
+        quantum_interval("quantum_interval", sc_time(10, SC_MS)) {
+        if (quantum_auto) {
+            VCML_ERROR_ON(quantum_min.get() > quantum_max.get(),
+                          "quantum_min must not exceed quantum_max");
+            VCML_ERROR_ON(quantum_interval.get() == SC_ZERO_TIME,
+                          "quantum_interval must not be zero");
+            SC_THREAD(quantum_tuner);
+        }
 
         if (backtrace)
             report::report_segfaults();
@@ -57,6 +175,8 @@ namespace vcml {
             log_info("simulation stopped");
         }
 
+        log_limiter::flush_all();
+        log_writer::flush_all();
         return EXIT_SUCCESS;
     }
 
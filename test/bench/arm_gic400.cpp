@@ -0,0 +1,51 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+static double measure_access(peripheral& p, u64 addr, unsigned int n) {
+    u32 data = 0;
+    tlm_generic_payload tx;
+    double start = realtime();
+    for (unsigned int i = 0; i < n; i++) {
+        tx_setup(tx, TLM_READ_COMMAND, addr, &data, sizeof(data));
+        p.transport(tx, SBI_CPUID(0));
+    }
+
+    return (realtime() - start) * 1e9 / n;
+}
+
+TEST(gic400, registers) {
+    double start = realtime();
+    arm::gic400* gic = new arm::gic400("gic");
+    printf("construction: %8.2fus\n", (realtime() - start) * 1e6);
+
+    const unsigned int n = 1000000;
+    printf("GICD_CTLR:           %6.2fns\n",
+           measure_access(gic->DISTIF, 0x000, n));
+    printf("GICD_IPRIORITY_SPI:  %6.2fns\n",
+           measure_access(gic->DISTIF, 0x420, n));
+    printf("GICD_ITARGETS_SPI:   %6.2fns\n",
+           measure_access(gic->DISTIF, 0x820, n));
+    printf("unmapped:            %6.2fns\n",
+           measure_access(gic->DISTIF, 0xf80, n));
+
+    start = realtime();
+    delete gic;
+    printf("destruction:  %8.2fus\n", (realtime() - start) * 1e6);
+}
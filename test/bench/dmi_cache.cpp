@@ -0,0 +1,94 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+static unsigned char dummy;
+
+static void fill(dmi_cache& cache, unsigned int regions) {
+    tlm_dmi dmi;
+    dmi.allow_read_write();
+    for (unsigned int i = 0; i < regions; i++) {
+        dmi.set_start_address(i * 0x2000ull);
+        dmi.set_end_address(i * 0x2000ull + 0xfff);
+        dmi.set_dmi_ptr(&dummy + dmi.get_start_address());
+        cache.insert(dmi);
+    }
+}
+
+static double measure(dmi_cache& cache, unsigned int regions, bool mru) {
+    const unsigned int n = 1000000;
+    unsigned int hits = 0;
+    tlm_dmi dmi;
+
+    double start = realtime();
+    for (unsigned int i = 0; i < n; i++) {
+        // mru: stay in one region, otherwise stride across all of them
+        u64 region = mru ? (regions / 2) : ((i * 7919ull) % regions);
+        u64 addr = region * 0x2000ull + (i & 0xff) * 4;
+        if (cache.lookup(addr, 4, TLM_READ_COMMAND, dmi))
+            hits++;
+    }
+
+    double duration = realtime() - start;
+    EXPECT_EQ(hits, n);
+    return duration * 1e9 / n;
+}
+
+TEST(dmi_cache, lookup) {
+    for (unsigned int regions : { 1, 4, 16, 64, 256, 1024, 4096 }) {
+        dmi_cache cache;
+        fill(cache, regions);
+        ASSERT_EQ(cache.get_entries().size(), regions);
+
+        double same = measure(cache, regions, true);
+        double rand = measure(cache, regions, false);
+
+        printf("%5u regions: %6.2fns/lookup (same region), "
+               "%6.2fns/lookup (scattered)\n", regions, same, rand);
+    }
+}
+
+TEST(dmi_cache, invalidate) {
+    for (unsigned int regions : { 1, 4, 16, 64, 256, 1024, 4096 }) {
+        dmi_cache cache;
+        fill(cache, regions);
+
+        // punch a hole into one region and restore it again, this is what
+        // happens on exclusive reads and invalidate/refetch cycles
+        const unsigned int n = 100000;
+        const u64 base = (regions / 2) * 0x2000ull;
+
+        tlm_dmi dmi;
+        dmi.allow_read_write();
+        dmi.set_start_address(base);
+        dmi.set_end_address(base + 0xfff);
+        dmi.set_dmi_ptr(&dummy + base);
+
+        double start = realtime();
+        for (unsigned int i = 0; i < n; i++) {
+            cache.invalidate(base + 0x100, base + 0x103);
+            cache.insert(dmi);
+        }
+
+        double duration = realtime() - start;
+        ASSERT_EQ(cache.get_entries().size(), regions);
+        printf("%5u regions: %6.2fns/invalidate+insert\n", regions,
+               duration * 1e9 / n);
+    }
+}
@@ -0,0 +1,91 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+class bus_bench: public test_base
+{
+public:
+    generic::memory mem;
+    generic::bus bus;
+    master_socket OUT;
+
+    unsigned int mappings;
+
+    bus_bench(const sc_module_name& nm):
+        test_base(nm),
+        mem("mem", 0x1000),
+        bus("bus"),
+        OUT("OUT"),
+        mappings(1) {
+        mem.CLOCK.stub(100 * MHz);
+        bus.CLOCK.stub(100 * MHz);
+        mem.RESET.stub();
+        bus.RESET.stub();
+
+        // force all accesses through b_transport and the bus decoder
+        allow_dmi = false;
+
+        bus.bind(OUT);
+        bus.bind(mem.IN, 0x0000, 0x0fff);
+    }
+
+    void grow(unsigned int n) {
+        for (; mappings < n; mappings++)
+            bus.map(0, mappings * 0x1000, mappings * 0x1000 + 0xfff);
+    }
+
+    double measure_lookup(unsigned int n) {
+        double start = realtime();
+        for (unsigned int i = 0; i < n; i++) {
+            u64 addr = ((i * 7919ull) % mappings) * 0x1000 + 0x10;
+            EXPECT_EQ(bus.lookup(range(addr, addr + 3)).port, 0);
+        }
+
+        return (realtime() - start) * 1e9 / n;
+    }
+
+    double measure_transport(unsigned int n, bool scatter) {
+        u32 data = 0;
+        double start = realtime();
+        for (unsigned int i = 0; i < n; i++) {
+            u64 page = scatter ? (i * 7919ull) % mappings : mappings / 2;
+            EXPECT_OK(OUT.readw<u32>(page * 0x1000 + 0x10, data));
+        }
+
+        return (realtime() - start) * 1e9 / n;
+    }
+
+    virtual void run_test() override {
+        const unsigned int n = 1000000;
+        const unsigned int counts[] = { 10, 100, 1000 };
+
+        for (unsigned int count : counts) {
+            grow(count);
+            printf("%4u mappings: lookup %6.2fns, transport %6.2fns (same "
+                   "target) %6.2fns (scattered)\n", mappings,
+                   measure_lookup(n), measure_transport(n, false),
+                   measure_transport(n, true));
+        }
+    }
+};
+
+TEST(generic_bus, decode) {
+    bus_bench bench("bench");
+    sc_core::sc_start();
+}
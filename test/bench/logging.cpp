@@ -0,0 +1,100 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+class null_logger: public logger
+{
+public:
+    size_t lines;
+
+    null_logger(): logger(LOG_ERROR, LOG_INFO), lines(0) {}
+    virtual void log_line(log_level lvl, const char* line) override {
+        lines++;
+    }
+};
+
+class log_bench: public test_base
+{
+public:
+    log_bench(const sc_module_name& nm):
+        test_base(nm) {
+        loglvl = LOG_INFO;
+    }
+
+    double measure_module(unsigned int n) {
+        double start = realtime();
+        for (unsigned int i = 0; i < n; i++)
+            log_info("message %u", i);
+        return (realtime() - start) * 1e9 / n;
+    }
+
+    double measure_global(unsigned int n) {
+        double start = realtime();
+        for (unsigned int i = 0; i < n; i++)
+            vcml::log_info("message %u", i);
+        return (realtime() - start) * 1e9 / n;
+    }
+
+    double measure_multiline(unsigned int n) {
+        double start = realtime();
+        for (unsigned int i = 0; i < n; i++)
+            log_info("first line %u\nsecond line\nthird line", i);
+        return (realtime() - start) * 1e9 / n;
+    }
+
+    double measure_file(unsigned int n) {
+        const char* filename = "/tmp/vcml_log_bench.txt";
+        log_file* file = new log_file(filename);
+        file->set_level(LOG_ERROR, LOG_INFO);
+
+        double start = realtime();
+        for (unsigned int i = 0; i < n; i++)
+            log_info("message %u", i);
+        file->flush();
+        double duration = realtime() - start;
+
+        delete file;
+        remove(filename);
+        return duration * 1e9 / n;
+    }
+
+    virtual void run_test() override {
+        const unsigned int n = 1000000;
+
+        null_logger null;
+        double module = measure_module(n);
+        double global = measure_global(n);
+        double multi = measure_multiline(n);
+        EXPECT_EQ(null.lines, 5 * n);
+
+        printf("module: %6.2fns/msg, global: %6.2fns/msg, "
+               "3 lines: %6.2fns/msg\n", module, global, multi);
+
+        loglvl = LOG_WARN;
+        printf("suppressed: %6.2fns/msg\n", measure_module(n));
+        loglvl = LOG_INFO;
+
+        printf("log file: %6.2fns/msg\n", measure_file(n));
+    }
+};
+
+TEST(logging, throughput) {
+    log_bench bench("bench");
+    sc_core::sc_start();
+}
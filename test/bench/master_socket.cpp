@@ -0,0 +1,75 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+class tlb_bench: public test_base
+{
+public:
+    generic::memory mem;
+    master_socket OUT;
+
+    tlb_bench(const sc_module_name& nm):
+        test_base(nm),
+        mem("mem", 1 * MiB),
+        OUT("OUT") {
+        OUT.bind(mem.IN);
+        mem.CLOCK.stub(100 * MHz);
+        mem.RESET.stub();
+    }
+
+    template <typename T>
+    double measure_readw(unsigned int n) {
+        T data = 0;
+        double start = realtime();
+        for (unsigned int i = 0; i < n; i++)
+            EXPECT_OK(OUT.readw<T>((i * sizeof(T)) % mem.size, data));
+        return (realtime() - start) * 1e9 / n;
+    }
+
+    template <typename T>
+    double measure_read(unsigned int n) {
+        T data = 0;
+        double start = realtime();
+        for (unsigned int i = 0; i < n; i++)
+            EXPECT_OK(OUT.read((i * sizeof(T)) % mem.size, &data, sizeof(T)));
+        return (realtime() - start) * 1e9 / n;
+    }
+
+    virtual void run_test() override {
+        const unsigned int n = 1000000;
+
+        // touch every page once to get DMI and TLB entries in place
+        for (u64 addr = 0; addr < mem.size; addr += 4)
+            ASSERT_OK(OUT.writew<u32>(addr, (u32)addr));
+
+        printf("readw<u8>:  %6.2fns (tlb) %6.2fns (dmi_cache)\n",
+               measure_readw<u8>(n), measure_read<u8>(n));
+        printf("readw<u16>: %6.2fns (tlb) %6.2fns (dmi_cache)\n",
+               measure_readw<u16>(n), measure_read<u16>(n));
+        printf("readw<u32>: %6.2fns (tlb) %6.2fns (dmi_cache)\n",
+               measure_readw<u32>(n), measure_read<u32>(n));
+        printf("readw<u64>: %6.2fns (tlb) %6.2fns (dmi_cache)\n",
+               measure_readw<u64>(n), measure_read<u64>(n));
+    }
+};
+
+TEST(master_socket, tlb) {
+    tlb_bench bench("bench");
+    sc_core::sc_start();
+}
@@ -0,0 +1,130 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+class mmio_target: public peripheral
+{
+public:
+    reg<mmio_target, u32> DATA;
+    slave_socket IN;
+
+    mmio_target(const sc_module_name& nm):
+        peripheral(nm),
+        DATA("DATA", 0x0, 0),
+        IN("IN") {
+        DATA.allow_read_write();
+    }
+};
+
+class mmio_initiator: public component
+{
+public:
+    master_socket OUT;
+
+    unsigned int count;
+    bool finished;
+
+    sc_event start;
+    sc_event done;
+
+    mmio_initiator(const sc_module_name& nm, unsigned int n):
+        component(nm),
+        OUT("OUT"),
+        count(n),
+        finished(false),
+        start("start"),
+        done("done") {
+        SC_HAS_PROCESS(mmio_initiator);
+        SC_THREAD(run);
+    }
+
+    void run() {
+        wait(start);
+
+        u32 data = 0;
+        for (unsigned int i = 0; i < count; i++)
+            EXPECT_OK(OUT.readw<u32>(0x0, data));
+
+        finished = true;
+        done.notify();
+    }
+};
+
+class mmio_bench: public test_base
+{
+public:
+    enum : unsigned int {
+        NINITIATORS = 8,
+        NACCESSES = 100000,
+    };
+
+    mmio_target target;
+    generic::bus bus;
+    vector<mmio_initiator*> initiators;
+
+    mmio_bench(const sc_module_name& nm):
+        test_base(nm),
+        target("target"),
+        bus("bus"),
+        initiators() {
+        target.CLOCK.stub(100 * MHz);
+        target.RESET.stub();
+        bus.CLOCK.stub(100 * MHz);
+        bus.RESET.stub();
+
+        bus.bind(target.IN, 0x0, 0xfff);
+
+        for (unsigned int i = 0; i <= NINITIATORS; i++) {
+            string name = "initiator" + to_string(i);
+            mmio_initiator* init = new mmio_initiator(name.c_str(), NACCESSES);
+            init->CLOCK.stub(100 * MHz);
+            init->RESET.stub();
+            bus.bind(init->OUT);
+            initiators.push_back(init);
+        }
+    }
+
+    virtual ~mmio_bench() {
+        for (auto init : initiators)
+            delete init;
+    }
+
+    double measure(unsigned int first, unsigned int n) {
+        double t = realtime();
+        for (unsigned int i = first; i < first + n; i++)
+            initiators[i]->start.notify();
+
+        for (unsigned int i = first; i < first + n; i++)
+            while (!initiators[i]->finished)
+                wait(initiators[i]->done);
+
+        return (realtime() - t) * 1e9 / (n * NACCESSES);
+    }
+
+    virtual void run_test() override {
+        printf("1 initiator:   %6.2fns per access\n", measure(0, 1));
+        printf("%u initiators: %6.2fns per access\n", NINITIATORS,
+               measure(1, NINITIATORS));
+    }
+};
+
+TEST(slave_socket, mmio) {
+    mmio_bench bench("bench");
+    sc_core::sc_start();
+}
@@ -36,10 +36,15 @@ public:
     slave_socket IN;
     master_socket OUT;
 
+    sc_process_b* other;
+    unsigned int num_writes;
+
     test_component(const sc_module_name& nm):
         component(nm),
         IN("IN"),
-        OUT("OUT") {
+        OUT("OUT"),
+        other(nullptr),
+        num_writes(0) {
 
         OUT.bind(IN);
 
@@ -48,6 +53,11 @@ public:
 
         SC_HAS_PROCESS(test_component);
         SC_THREAD(run_test);
+        SC_THREAD(run_other);
+    }
+
+    void run_other() {
+        other = sc_get_current_process_b();
     }
 
     virtual unsigned int transport(tlm_generic_payload& tx,
@@ -55,6 +65,8 @@ public:
         EXPECT_EQ(tx.get_address(), 0x0);
         EXPECT_EQ(tx.get_data_length(), 4);
         EXPECT_NE(tx.get_data_ptr(), nullptr);
+        if (tx.is_write())
+            num_writes++;
         tx.set_response_status(TLM_OK_RESPONSE);
         return tx.get_data_length();
     }
@@ -84,6 +96,21 @@ public:
         ASSERT_OK(OUT.writew<u32>(0, data))
             << "component did not respond to write command";
 
+        unsigned int writes = num_writes;
+        ASSERT_CE(OUT.atomicw<u32>(VCML_ATOMIC_ADD, 0, data, 0, SBI_NODMI))
+            << "atomic access to unaware component did not fail";
+        EXPECT_EQ(num_writes, writes)
+            << "unaware component received the atomic as a plain store";
+
+        local_time() = sc_time(10, SC_NS);
+        ASSERT_NE(other, nullptr);
+        EXPECT_EQ(local_time(other), SC_ZERO_TIME)
+            << "processes share the same local time offset";
+        local_time(other) = sc_time(20, SC_NS);
+        EXPECT_EQ(local_time(), sc_time(10, SC_NS))
+            << "local time offset changed by another process";
+        local_time() = SC_ZERO_TIME;
+
         sc_stop();
         return;
     }
@@ -48,10 +48,10 @@ TEST(dmi, insert) {
     dmi.set_dmi_ptr(&dummy + dmi.get_start_address());
     cache.insert(dmi);
     EXPECT_EQ(cache.get_entries().size(), 2);
-    EXPECT_EQ(cache.get_entries()[1].get_start_address(), 0);
-    EXPECT_EQ(cache.get_entries()[1].get_end_address(), 1100);
-    EXPECT_EQ(cache.get_entries()[0].get_start_address(), 1200);
-    EXPECT_EQ(cache.get_entries()[0].get_end_address(), 1500);
+    EXPECT_EQ(cache.get_entries()[0].get_start_address(), 0);
+    EXPECT_EQ(cache.get_entries()[0].get_end_address(), 1100);
+    EXPECT_EQ(cache.get_entries()[1].get_start_address(), 1200);
+    EXPECT_EQ(cache.get_entries()[1].get_end_address(), 1500);
 
     dmi.set_start_address(1000);
     dmi.set_end_address(1200);
@@ -63,7 +63,37 @@ TEST(dmi, insert) {
 
     dmi.allow_read();
     cache.insert(dmi);
-    EXPECT_EQ(cache.get_entries().size(), 2);
+    EXPECT_EQ(cache.get_entries().size(), 3);
+    EXPECT_EQ(cache.get_entries()[0].get_start_address(), 0);
+    EXPECT_EQ(cache.get_entries()[0].get_end_address(), 999);
+    EXPECT_EQ(cache.get_entries()[1].get_start_address(), 1000);
+    EXPECT_EQ(cache.get_entries()[1].get_end_address(), 1200);
+    EXPECT_EQ(cache.get_entries()[2].get_start_address(), 1201);
+    EXPECT_EQ(cache.get_entries()[2].get_end_address(), 1500);
+    EXPECT_EQ(cache.get_entries()[2].get_dmi_ptr(), &dummy + 1201);
+}
+
+TEST(dmi, unlimited) {
+    unsigned char dummy;
+    vcml::dmi_cache cache;
+    tlm::tlm_dmi dmi, dmi2;
+
+    dmi.allow_read_write();
+    for (unsigned int i = 0; i < 100; i++) {
+        dmi.set_start_address(i * 0x100);
+        dmi.set_end_address(i * 0x100 + 0x7f);
+        dmi.set_dmi_ptr(&dummy + dmi.get_start_address());
+        cache.insert(dmi);
+    }
+
+    ASSERT_EQ(cache.get_entries().size(), 100);
+    for (unsigned int i = 0; i < 100; i++) {
+        EXPECT_TRUE(cache.lookup(i * 0x100 + 4, 4, tlm::TLM_READ_COMMAND,
+                                 dmi2));
+        EXPECT_EQ(dmi2.get_start_address(), i * 0x100);
+        EXPECT_FALSE(cache.lookup(i * 0x100 + 0x80, 4, tlm::TLM_READ_COMMAND,
+                                  dmi2));
+    }
 }
 
 TEST(dmi, invalidate) {
@@ -92,10 +122,58 @@ TEST(dmi, invalidate) {
 
     cache.invalidate(400, 500);
     EXPECT_EQ(cache.get_entries().size(), 2);
-    EXPECT_EQ(cache.get_entries()[1].get_start_address(), 100);
-    EXPECT_EQ(cache.get_entries()[1].get_end_address(), 399);
-    EXPECT_EQ(cache.get_entries()[0].get_start_address(), 501);
-    EXPECT_EQ(cache.get_entries()[0].get_end_address(), 899);
+    EXPECT_EQ(cache.get_entries()[0].get_start_address(), 100);
+    EXPECT_EQ(cache.get_entries()[0].get_end_address(), 399);
+    EXPECT_EQ(cache.get_entries()[1].get_start_address(), 501);
+    EXPECT_EQ(cache.get_entries()[1].get_end_address(), 899);
+}
+
+TEST(dmi, invalidate_partial) {
+    unsigned char dummy;
+    vcml::dmi_cache cache;
+    tlm::tlm_dmi dmi;
+
+    dmi.allow_read_write();
+    for (unsigned int i = 0; i < 4; i++) {
+        dmi.set_start_address(i * 100);
+        dmi.set_end_address(i * 100 + 49);
+        dmi.set_dmi_ptr(&dummy + dmi.get_start_address());
+        cache.insert(dmi);
+    }
+
+    ASSERT_EQ(cache.get_entries().size(), 4);
+
+    // trims the end of entry 0, drops entry 1, trims the start of entry 2
+    cache.invalidate(40, 209);
+    ASSERT_EQ(cache.get_entries().size(), 3);
+    EXPECT_EQ(cache.get_entries()[0].get_start_address(), 0);
+    EXPECT_EQ(cache.get_entries()[0].get_end_address(), 39);
+    EXPECT_EQ(cache.get_entries()[1].get_start_address(), 210);
+    EXPECT_EQ(cache.get_entries()[1].get_end_address(), 249);
+    EXPECT_EQ(cache.get_entries()[1].get_dmi_ptr(), &dummy + 210);
+    EXPECT_EQ(cache.get_entries()[2].get_start_address(), 300);
+    EXPECT_EQ(cache.get_entries()[2].get_end_address(), 349);
+
+    // splits entry 2 and keeps single byte remainders
+    cache.invalidate(301, 348);
+    ASSERT_EQ(cache.get_entries().size(), 4);
+    EXPECT_EQ(cache.get_entries()[2].get_start_address(), 300);
+    EXPECT_EQ(cache.get_entries()[2].get_end_address(), 300);
+    EXPECT_EQ(cache.get_entries()[3].get_start_address(), 349);
+    EXPECT_EQ(cache.get_entries()[3].get_end_address(), 349);
+    EXPECT_EQ(cache.get_entries()[3].get_dmi_ptr(), &dummy + 349);
+
+    // gaps between entries do not affect anything
+    cache.invalidate(250, 299);
+    EXPECT_EQ(cache.get_entries().size(), 4);
+
+    // exact matches remove the entry entirely
+    cache.invalidate(210, 249);
+    ASSERT_EQ(cache.get_entries().size(), 3);
+    EXPECT_EQ(cache.get_entries()[1].get_start_address(), 300);
+
+    cache.invalidate(0, -1);
+    EXPECT_TRUE(cache.get_entries().empty());
 }
 
 TEST(dmi, lookup) {
@@ -47,7 +47,7 @@ TEST(exmon, update) {
 
     EXPECT_TRUE(mon.update(tx));
     ASSERT_EQ(mon.get_locks().size(), 1);
-    EXPECT_EQ(mon.get_locks()[0].addr, vcml::range(100, 103));
+    EXPECT_EQ(mon.get_locks()[0].addr, vcml::range(64, 127));
     EXPECT_EQ(mon.get_locks()[0].cpu, ex1.cpuid);
 
     tx.clear_extension(&ex1);
@@ -55,7 +55,7 @@ TEST(exmon, update) {
 
     EXPECT_TRUE(mon.update(tx));
     ASSERT_EQ(mon.get_locks().size(), 2);
-    EXPECT_EQ(mon.get_locks()[1].addr, vcml::range(100, 103));
+    EXPECT_EQ(mon.get_locks()[1].addr, vcml::range(64, 127));
     EXPECT_EQ(mon.get_locks()[1].cpu, ex2.cpuid);
 
     tx.set_write();
@@ -72,7 +72,7 @@ TEST(exmon, update) {
 }
 
 TEST(exmon, dmi) {
-    vcml::exmon mon;
+    vcml::exmon mon(1);
 
     mon.add_lock(0, {100, 199});
     mon.add_lock(1, {300, 399});
@@ -120,3 +120,30 @@ TEST(exmon, dmi) {
     EXPECT_EQ(dmi.get_end_address(), -1);
     EXPECT_EQ(dmi.get_dmi_ptr(), (unsigned char*)400);
 }
+
+TEST(exmon, granule) {
+    vcml::exmon mon;
+    EXPECT_EQ(mon.get_granule(), 64);
+
+    mon.add_lock(0, {0x104, 0x107});
+    mon.add_lock(1, {0x200, 0x203});
+    ASSERT_EQ(mon.get_locks().size(), 2);
+    EXPECT_TRUE(mon.has_lock(0, {0x100, 0x13f}));
+    EXPECT_TRUE(mon.conflicts({0x13c, 0x13f}));
+    EXPECT_FALSE(mon.conflicts({0x140, 0x1ff}));
+    EXPECT_TRUE(mon.conflicts({0x0, 0xffff}));
+
+    // writes to any other part of the granule clear the reservation
+    mon.break_locks({0x138, 0x13b});
+    ASSERT_EQ(mon.get_locks().size(), 1);
+    EXPECT_EQ(mon.get_locks()[0].cpu, 1);
+    EXPECT_FALSE(mon.conflicts({0x100, 0x13f}));
+
+    mon.break_locks(1);
+    EXPECT_FALSE(mon.has_locks());
+    EXPECT_FALSE(mon.conflicts({0x0, 0xffff}));
+
+    mon.set_granule(16);
+    mon.add_lock(0, {0x104, 0x107});
+    EXPECT_EQ(mon.get_locks()[0].addr, vcml::range(0x100, 0x10f));
+}
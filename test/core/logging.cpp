@@ -16,6 +16,9 @@
  *                                                                            *
  ******************************************************************************/
 
+#include <thread>
+#include <future>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -133,6 +136,13 @@ TEST(logging, hierarchy) {
     EXPECT_EQ(comp2.subcomp.loglvl.get(), vcml::LOG_INFO);
 }
 
+TEST(logging, null_origin) {
+    mock_logger logger;
+    const sc_core::sc_object* org = nullptr;
+    EXPECT_CALL(logger, log_line(vcml::LOG_INFO,_)).Times(1);
+    vcml::logger::log(vcml::LOG_INFO, org, "message without origin");
+}
+
 TEST(logging, reporting) {
     vcml::log_term cons;
     mock_logger logger;
@@ -141,3 +151,246 @@ TEST(logging, reporting) {
     vcml::report rep("This is an error message - things are really bad", __FILE__, __LINE__);
     vcml::logger::log(rep);
 }
+
+TEST(logging, rate_limit) {
+    mock_logger logger;
+    logger.set_level(vcml::LOG_WARN);
+
+    vcml::component comp("limited");
+    comp.log_rate = 5;
+
+    auto storm = [&comp](int i) -> void {
+        comp.log_warn("message storm %d", i);
+    };
+
+    EXPECT_CALL(logger, log_line(vcml::LOG_WARN,_)).Times(5);
+    for (int i = 0; i < 100; i++)
+        storm(i);
+    Mock::VerifyAndClearExpectations(&logger);
+
+    // periodic summaries report what has been dropped so far
+    EXPECT_CALL(logger, log_line(vcml::LOG_WARN,
+                HasSubstr("suppressed 95 similar messages"))).Times(1);
+    vcml::log_limiter::flush_all();
+    Mock::VerifyAndClearExpectations(&logger);
+
+    EXPECT_CALL(logger, log_line(_,_)).Times(0);
+    vcml::log_limiter::flush_all(); // nothing left to report
+}
+
+TEST(logging, rate_limit_clock) {
+    mock_logger logger;
+    logger.set_level(vcml::LOG_WARN);
+
+    double now = 0.0;
+    vcml::log_limiter limiter("clocked", [&now]() -> double { return now; });
+    const char* format = "clocked message";
+
+    unsigned int allowed = 0;
+    for (int i = 0; i < 10; i++)
+        allowed += limiter.allow(vcml::LOG_WARN, format, 2) ? 1 : 0;
+    EXPECT_EQ(allowed, 2);
+
+    // bucket refills with two tokens per second
+    now = 0.25;
+    EXPECT_FALSE(limiter.allow(vcml::LOG_WARN, format, 2));
+
+    now = 0.5;
+    EXPECT_CALL(logger, log_line(vcml::LOG_WARN,
+                HasSubstr("suppressed 9 similar messages"))).Times(1);
+    EXPECT_TRUE(limiter.allow(vcml::LOG_WARN, format, 2));
+    EXPECT_FALSE(limiter.allow(vcml::LOG_WARN, format, 2));
+}
+
+TEST(logging, trace_file) {
+    const char* filename = "/tmp/vcml_trace_test.bin";
+    vcml::u32 data = 0x11223344;
+
+    tlm::tlm_generic_payload tx;
+    tx.set_command(tlm::TLM_WRITE_COMMAND);
+    tx.set_address(0x1000);
+    tx.set_data_ptr((unsigned char*)&data);
+    tx.set_data_length(sizeof(data));
+    tx.set_response_status(tlm::TLM_OK_RESPONSE);
+
+    vcml::trace_file* tracer = new vcml::trace_file(filename);
+    EXPECT_EQ(vcml::trace_file::instance(), tracer);
+    vcml::logger::trace_fw("mock.OUT", tx, sc_core::SC_ZERO_TIME);
+    vcml::logger::trace_bw("mock.OUT", tx, sc_core::SC_ZERO_TIME);
+    delete tracer;
+    EXPECT_EQ(vcml::trace_file::instance(), nullptr);
+
+    std::ifstream file(filename, std::ios::binary);
+    ASSERT_TRUE(file.good());
+
+    vcml::trace_header header;
+    file.read((char*)&header, sizeof(header));
+    EXPECT_EQ(memcmp(header.magic, vcml::TRACE_MAGIC, sizeof(header.magic)), 0);
+    EXPECT_EQ(header.record_size, sizeof(vcml::trace_record));
+
+    // name definition, followed by one record holding its characters
+    vcml::trace_record rec;
+    file.read((char*)&rec, sizeof(rec));
+    EXPECT_EQ(rec.type, vcml::TRACE_RECORD_NAME);
+    EXPECT_EQ(rec.size, strlen("mock.OUT"));
+    file.read((char*)&rec, sizeof(rec));
+    EXPECT_STREQ((const char*)&rec, "mock.OUT");
+
+    for (bool forward : { true, false }) {
+        file.read((char*)&rec, sizeof(rec));
+        ASSERT_TRUE(file.good());
+        EXPECT_EQ(rec.type, vcml::TRACE_RECORD_TX);
+        EXPECT_EQ(rec.flags & vcml::TRACE_FLAG_FORWARD ? true : false, forward);
+        EXPECT_EQ(rec.command, tlm::TLM_WRITE_COMMAND);
+        EXPECT_EQ(rec.addr, 0x1000);
+        EXPECT_EQ(rec.size, sizeof(data));
+        EXPECT_EQ(rec.response, tlm::TLM_OK_RESPONSE);
+        EXPECT_EQ(rec.nbytes, sizeof(data));
+        EXPECT_EQ(memcmp(rec.data, &data, sizeof(data)), 0);
+    }
+
+    file.read((char*)&rec, sizeof(rec));
+    EXPECT_TRUE(file.eof());
+    remove(filename);
+}
+
+TEST(logging, trace_file_reopen) {
+    const char* filename = "/tmp/vcml_trace_test2.bin";
+    vcml::u32 data = 0x11223344;
+
+    tlm::tlm_generic_payload tx;
+    tx.set_command(tlm::TLM_READ_COMMAND);
+    tx.set_address(0x2000);
+    tx.set_data_ptr((unsigned char*)&data);
+    tx.set_data_length(sizeof(data));
+    tx.set_response_status(tlm::TLM_OK_RESPONSE);
+
+    // a thread that outlives a trace file must not keep using its ring
+    std::promise<void> recorded, reopened;
+    std::future<void> recorded_f = recorded.get_future();
+    std::future<void> reopened_f = reopened.get_future();
+
+    vcml::trace_file* tracer = new vcml::trace_file(filename);
+    std::thread th([&]() {
+        vcml::trace_file::instance()->record(true, "mock.A", tx,
+                                             sc_core::SC_ZERO_TIME);
+        recorded.set_value();
+        reopened_f.wait();
+        vcml::trace_file::instance()->record(true, "mock.B", tx,
+                                             sc_core::SC_ZERO_TIME);
+    });
+
+    recorded_f.wait();
+    delete tracer;
+    tracer = new vcml::trace_file(filename);
+    reopened.set_value();
+    th.join();
+    delete tracer;
+
+    std::ifstream file(filename, std::ios::binary);
+    ASSERT_TRUE(file.good());
+
+    vcml::trace_header header;
+    file.read((char*)&header, sizeof(header));
+
+    vcml::trace_record rec;
+    file.read((char*)&rec, sizeof(rec));
+    EXPECT_EQ(rec.type, vcml::TRACE_RECORD_NAME);
+    file.read((char*)&rec, sizeof(rec));
+    EXPECT_STREQ((const char*)&rec, "mock.B");
+
+    file.read((char*)&rec, sizeof(rec));
+    ASSERT_TRUE(file.good());
+    EXPECT_EQ(rec.type, vcml::TRACE_RECORD_TX);
+    EXPECT_EQ(rec.origin, 0u);
+    EXPECT_EQ(rec.addr, 0x2000);
+
+    file.read((char*)&rec, sizeof(rec));
+    EXPECT_TRUE(file.eof());
+    remove(filename);
+}
+
+TEST(logging, log_file) {
+    const char* filename = "/tmp/vcml_log_test.txt";
+    vcml::log_file* log = new vcml::log_file(filename);
+    log->set_level(vcml::LOG_ERROR, vcml::LOG_INFO);
+
+    vcml::log_info("first message");
+    log->flush();
+
+    std::ifstream file(filename);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    EXPECT_THAT(ss.str(), HasSubstr("first message\n"))
+        << "flush did not write pending log lines";
+
+    for (int i = 0; i < 1000; i++)
+        vcml::log_info("message %d", i);
+    delete log;
+
+    std::ifstream file2(filename);
+    size_t lines = 0;
+    std::string line;
+    while (std::getline(file2, line))
+        lines++;
+    EXPECT_EQ(lines, 1001) << "log lines lost while closing log file";
+    remove(filename);
+}
+
+static void log_and_abort(const char* filename) {
+    vcml::log_file* log = new vcml::log_file(filename);
+    log->set_level(vcml::LOG_ERROR, vcml::LOG_INFO);
+    vcml::log_info("last words");
+    VCML_ERROR("aborting now");
+}
+
+TEST(logging, log_file_abort) {
+    const char* filename = "/tmp/vcml_log_abort.txt";
+    EXPECT_DEATH(log_and_abort(filename), "aborting now");
+
+    std::ifstream file(filename);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    EXPECT_THAT(ss.str(), HasSubstr("last words\n"))
+        << "pending log lines lost on abort";
+    remove(filename);
+}
+
+TEST(logging, trace_predicate) {
+    vcml::u32 data = 0;
+    tlm::tlm_generic_payload tx;
+    tx.set_command(tlm::TLM_READ_COMMAND);
+    tx.set_address(0x1ffe);
+    tx.set_data_ptr((unsigned char*)&data);
+    tx.set_data_length(sizeof(data));
+    tx.set_response_status(tlm::TLM_OK_RESPONSE);
+
+    vcml::trace_predicate all;
+    EXPECT_TRUE(all.is_empty());
+    EXPECT_TRUE(all.matches(tx, true));
+    EXPECT_TRUE(all.matches(tx, false));
+
+    vcml::trace_predicate window("addr=0x2000-0x2fff, read");
+    EXPECT_FALSE(window.is_empty());
+    EXPECT_TRUE(window.matches(tx, true));
+    tx.set_command(tlm::TLM_WRITE_COMMAND);
+    EXPECT_FALSE(window.matches(tx, true));
+    tx.set_command(tlm::TLM_READ_COMMAND);
+    tx.set_address(0x1000);
+    EXPECT_FALSE(window.matches(tx, true));
+
+    vcml::trace_predicate errors("errors");
+    EXPECT_FALSE(errors.matches(tx, true));
+    EXPECT_FALSE(errors.matches(tx, false));
+    tx.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+    EXPECT_FALSE(errors.matches(tx, true));
+    EXPECT_TRUE(errors.matches(tx, false));
+
+    // transactions without sideband information originate from cpu 0
+    vcml::trace_predicate cpus("cpu=1,cpu=2");
+    EXPECT_FALSE(cpus.matches(tx, true));
+    EXPECT_TRUE(vcml::trace_predicate("cpu=0").matches(tx, true));
+
+    EXPECT_DEATH(vcml::trace_predicate("addr=0x20-0x10"), "invalid address");
+    EXPECT_DEATH(vcml::trace_predicate("bogus"), "unknown token");
+}
@@ -55,3 +55,25 @@ TEST(module, commands) {
     EXPECT_FALSE(mod.execute("test", std::vector<std::string>(), ss));
     EXPECT_FALSE(ss.str().empty());
 }
+
+TEST(module, trace_filter) {
+    mock_module mod("mock_trace");
+    mod.loglvl = vcml::LOG_TRACE;
+
+    vcml::u32 data = 0;
+    tlm::tlm_generic_payload tx;
+    tx.set_command(tlm::TLM_READ_COMMAND);
+    tx.set_address(0x1000);
+    tx.set_data_ptr((unsigned char*)&data);
+    tx.set_data_length(sizeof(data));
+    tx.set_response_status(tlm::TLM_OK_RESPONSE);
+
+    mod.set_trace_filter("addr=0x2000-0x2fff");
+    EXPECT_FALSE(mod.is_traced(tx, true));
+
+    // changing the property directly, e.g. via the session, also applies
+    mod.trace_filter.str("addr=0x1000-0x1fff");
+    EXPECT_TRUE(mod.is_traced(tx, true));
+    mod.trace_filter = "write";
+    EXPECT_FALSE(mod.is_traced(tx, true));
+}
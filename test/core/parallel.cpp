@@ -0,0 +1,131 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+
+using namespace ::testing;
+
+#include "vcml.h"
+
+static std::mutex g_mutex;
+static std::condition_variable g_arrival;
+static unsigned int g_arrived = 0;
+
+class parallel_processor: public vcml::processor
+{
+public:
+    vcml::u64 cycles;
+    vcml::u64 addr;
+    unsigned int num_quanta;
+    unsigned int num_workers;
+
+    parallel_processor(const sc_core::sc_module_name& nm, vcml::u64 a):
+        vcml::processor(nm),
+        cycles(0),
+        addr(a),
+        num_quanta(0),
+        num_workers(0) {
+        parallel = true;
+    }
+
+    virtual ~parallel_processor() {}
+
+    virtual vcml::u64 cycle_count() const override {
+        return cycles;
+    }
+
+    virtual void simulate(unsigned int n) override {
+        if (vcml::thctl_is_worker_thread())
+            num_workers++;
+
+        // rendezvous with the other processor within this quantum, this
+        // only completes if both processors simulate at the same time
+        {
+            std::unique_lock<std::mutex> lock(g_mutex);
+            const unsigned int expected = 2 * (num_quanta + 1);
+            g_arrived++;
+            g_arrival.notify_all();
+            EXPECT_TRUE(g_arrival.wait_for(lock, std::chrono::seconds(10),
+                        [=]() { return g_arrived >= expected; }))
+                << "processors did not run in parallel";
+        }
+
+        EXPECT_EQ(local_time_stamp(), sc_core::sc_time_stamp());
+
+        vcml::u32 data = 0;
+        EXPECT_EQ(DATA.writew<vcml::u32>(addr, num_quanta),
+                  tlm::TLM_OK_RESPONSE);
+        EXPECT_EQ(DATA.readw<vcml::u32>(addr, data), tlm::TLM_OK_RESPONSE);
+        EXPECT_EQ(data, num_quanta);
+
+        // unmapped addresses need the SystemC thread to report an error
+        EXPECT_EQ(DATA.readw<vcml::u32>(0x2000, data),
+                  tlm::TLM_ADDRESS_ERROR_RESPONSE);
+
+        cycles += n;
+        num_quanta++;
+    }
+};
+
+TEST(processor, parallel) {
+    sc_core::sc_signal<clock_t> clk("CLK");
+    sc_core::sc_signal<bool> rst("RST");
+
+    vcml::generic::memory mem("MEM", 0x1000);
+    vcml::generic::bus bus("BUS");
+
+    parallel_processor cpu0("CPU0", 0x100);
+    parallel_processor cpu1("CPU1", 0x200);
+
+    cpu0.CLOCK.bind(clk);
+    cpu0.RESET.bind(rst);
+    cpu1.CLOCK.bind(clk);
+    cpu1.RESET.bind(rst);
+    mem.CLOCK.bind(clk);
+    mem.RESET.bind(rst);
+    bus.CLOCK.bind(clk);
+    bus.RESET.bind(rst);
+
+    bus.bind(cpu0.INSN);
+    bus.bind(cpu0.DATA);
+    bus.bind(cpu1.INSN);
+    bus.bind(cpu1.DATA);
+    bus.bind(mem.IN, 0x0000, 0x0fff, 0);
+
+    clk.write(1 * vcml::kHz);
+    rst.write(false);
+
+    sc_core::sc_start(sc_core::SC_ZERO_TIME);
+
+    sc_core::sc_time quantum(1.0, sc_core::SC_SEC);
+    tlm::tlm_global_quantum::instance().set(quantum);
+
+    sc_core::sc_start(10 * quantum);
+
+    ASSERT_GE(cpu0.num_quanta, 10);
+    EXPECT_EQ(cpu0.num_quanta, cpu1.num_quanta);
+    EXPECT_EQ(cpu0.num_workers, cpu0.num_quanta);
+    EXPECT_EQ(cpu1.num_workers, cpu1.num_quanta);
+
+    EXPECT_EQ(*(vcml::u32*)(mem.get_data_ptr() + 0x200), cpu1.num_quanta - 1);
+}
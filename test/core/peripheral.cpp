@@ -173,3 +173,26 @@ TEST(peripheral, transporting_byte_enable_with_streaming) {
     EXPECT_EQ(tx.get_response_status(), tlm::TLM_ADDRESS_ERROR_RESPONSE);
     EXPECT_EQ(local, cycle * mock.write_latency * npulses);
 }
+
+TEST(peripheral, transporting_byte_enable_runs) {
+    mock_peripheral mock;
+    vcml::tlm_generic_payload tx;
+    sc_core::sc_time cycle(1.0 / mock.CLOCK, sc_core::SC_SEC);
+    sc_core::sc_time& local = mock.local_time();
+    unsigned char buffer[100];
+
+    local = sc_core::SC_ZERO_TIME;
+    vcml::u8 byte_enable[8] = { 0xff, 0xff, 0x00, 0xff,
+                                0xff, 0xff, 0xff, 0x00 };
+    vcml::tx_setup(tx, tlm::TLM_WRITE_COMMAND, 4, buffer, 8);
+    tx.set_byte_enable_length(8);
+    tx.set_byte_enable_ptr(byte_enable);
+
+    EXPECT_CALL(mock, read(_,_,_)).Times(0);
+    EXPECT_CALL(mock, write(vcml::range(4, 5), buffer + 0, vcml::SBI_NONE));
+    EXPECT_CALL(mock, write(vcml::range(7, 10), buffer + 3, vcml::SBI_NONE));
+    EXPECT_EQ(mock.transport(tx, vcml::SBI_NONE), 0);
+    EXPECT_EQ(tx.get_response_status(), tlm::TLM_ADDRESS_ERROR_RESPONSE);
+    EXPECT_EQ(tx.get_byte_enable_ptr(), byte_enable);
+    EXPECT_EQ(local, cycle * mock.write_latency);
+}
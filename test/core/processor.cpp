@@ -46,6 +46,10 @@ public:
         ASSERT_EQ(local_time(), clock_cycles(n));
     }
 
+    void wfi() {
+        wait_for_interrupt();
+    }
+
     MOCK_METHOD2(interrupt, void(unsigned int,bool));
     MOCK_METHOD1(simulatem, void(unsigned int));
     MOCK_METHOD0(reset, void(void));
@@ -144,4 +148,49 @@ TEST(processor, processor) {
     EXPECT_CALL(cpu, simulatem(quantum / cycle)).Times(AtLeast(9));
     EXPECT_CALL(cpu, handle_clock_update(Eq(0), Eq(defclk))).Times(1);
     sc_core::sc_start(10 * quantum);
+
+
+
+    // test processor::wait_for_interrupt
+    EXPECT_CALL(cpu, simulatem(quantum / cycle))
+        .WillOnce(InvokeWithoutArgs(&cpu, &mock_processor::wfi));
+    sc_core::sc_start(10 * quantum);
+    EXPECT_GE(cpu.get_cycles_skipped(), (vcml::u64)(8 * (quantum / cycle)))
+        << "idle cycles were not skipped";
+
+    irq1.write(true);
+    EXPECT_CALL(cpu, interrupt(1, true)).Times(1);
+    EXPECT_CALL(cpu, simulatem(quantum / cycle)).Times(AtLeast(1));
+    sc_core::sc_start(2 * quantum);
+
+    // interrupts raised while syncing before going idle must wake us up
+    vcml::u64 skipped = cpu.get_cycles_skipped();
+    EXPECT_CALL(cpu, interrupt(0, true)).Times(1);
+    EXPECT_CALL(cpu, simulatem(quantum / cycle))
+        .Times(AtLeast(4))
+        .WillOnce(DoAll(InvokeWithoutArgs([&]() { irq0.write(true); }),
+                        InvokeWithoutArgs(&cpu, &mock_processor::wfi)))
+        .WillRepeatedly(Return());
+    sc_core::sc_start(5 * quantum);
+    EXPECT_EQ(cpu.get_cycles_skipped(), skipped)
+        << "interrupt during sync was lost";
+
+    // events not wired to an IRQ must still end the idle period
+    sc_core::sc_event timer;
+    timer.notify(3 * quantum);
+    EXPECT_CALL(cpu, simulatem(quantum / cycle))
+        .Times(AtLeast(2))
+        .WillOnce(InvokeWithoutArgs(&cpu, &mock_processor::wfi))
+        .WillRepeatedly(Return());
+    sc_core::sc_start(5 * quantum);
+    EXPECT_GT(cpu.get_cycles_skipped(), skipped)
+        << "idle cycles were not skipped until the next event";
+
+
+
+    // test processor::horizon
+    cpu.horizon = 10 * quantum;
+    EXPECT_CALL(cpu, simulatem(quantum / cycle)).Times(AtMost(1));
+    EXPECT_CALL(cpu, simulatem(10 * quantum / cycle)).Times(Between(2, 3));
+    sc_core::sc_start(30 * quantum);
 }
@@ -319,6 +319,30 @@ TEST(registers, banking) {
     tx.clear_extension(&bank);
 }
 
+TEST(registers, bank_limit) {
+    mock_peripheral mock;
+    mock.test_reg_a.set_banked(true, 4);
+    EXPECT_EQ(mock.test_reg_a.num_banks(), 4);
+
+    // banks are allocated up front, so references stay valid
+    vcml::u32& bank1 = mock.test_reg_a.bank(1);
+    bank1 = 0x11;
+    mock.test_reg_a.bank(3) = 0x33;
+    EXPECT_EQ(&bank1, &mock.test_reg_a.bank(1));
+    EXPECT_EQ(bank1, 0x11);
+    EXPECT_EQ(mock.test_reg_a.bank(3), 0x33);
+
+    // banks beyond the limit read as default and are allocated on write
+    const auto& creg = mock.test_reg_a;
+    EXPECT_EQ(creg.bank(40), creg.get_default());
+    mock.test_reg_a.bank(40) = 0x40;
+    EXPECT_EQ(creg.bank(40), 0x40);
+    EXPECT_EQ(&bank1, &mock.test_reg_a.bank(1));
+
+    mock.test_reg_a.reset();
+    EXPECT_EQ(creg.bank(40), creg.get_default());
+}
+
 TEST(registers, endianess) {
     mock_peripheral mock;
     mock.set_big_endian();
@@ -344,3 +368,43 @@ TEST(registers, endianess) {
     EXPECT_EQ(local, cycle * mock.write_latency);
     EXPECT_TRUE(tx.is_response_ok());
 }
+
+class mock_peripheral_be: public vcml::peripheral {
+public:
+    vcml::reg<mock_peripheral_be, u32, 1, vcml::VCML_ENDIAN_BIG> test_reg;
+
+    mock_peripheral_be(const sc_core::sc_module_name& nm = "mock_be"):
+        vcml::peripheral(nm, vcml::VCML_ENDIAN_LITTLE, 1, 10),
+        test_reg("test_reg", 0x0, 0x11223344) {
+        test_reg.allow_read_write();
+        CLOCK.stub(100 * vcml::MHz);
+        RESET.stub();
+        handle_clock_update(0, CLOCK.read());
+    }
+};
+
+TEST(registers, static_endianess) {
+    mock_peripheral_be mock;
+    tlm::tlm_generic_payload tx;
+    u32 buffer = 0;
+
+    // byte order is fixed at compile time, peripheral endianess is ignored
+    vcml::tx_setup(tx, tlm::TLM_READ_COMMAND, 0, &buffer, 4);
+    EXPECT_EQ(mock.transport(tx, vcml::SBI_NONE), 4);
+    EXPECT_TRUE(tx.is_response_ok());
+    EXPECT_EQ(buffer, 0x44332211);
+
+    buffer = 0xeeff00cc;
+    vcml::tx_setup(tx, tlm::TLM_WRITE_COMMAND, 0, &buffer, 4);
+    EXPECT_EQ(mock.transport(tx, vcml::SBI_NONE), 4);
+    EXPECT_TRUE(tx.is_response_ok());
+    EXPECT_EQ(mock.test_reg, 0xcc00ffeeu);
+    EXPECT_EQ(buffer, 0xeeff00cc);
+
+    // partial accesses take the generic route
+    vcml::u16 half = 0;
+    vcml::tx_setup(tx, tlm::TLM_READ_COMMAND, 0, &half, 2);
+    EXPECT_EQ(mock.transport(tx, vcml::SBI_NONE), 2);
+    EXPECT_TRUE(tx.is_response_ok());
+    EXPECT_EQ(half, 0xeeff);
+}
@@ -18,38 +18,97 @@
 
 #include "testing.h"
 
+class prefetcher: public component
+{
+public:
+    master_socket OUT;
+
+    prefetcher(const sc_module_name& nm):
+        component(nm),
+        OUT("OUT") {
+        dmi_prefetch = true;
+    }
+};
+
+class mmio_target: public peripheral
+{
+public:
+    reg<mmio_target, u32> DATA;
+    slave_socket IN;
+
+    mmio_target(const sc_module_name& nm):
+        peripheral(nm),
+        DATA("DATA", 0x4, 0),
+        IN("IN") {
+        DATA.allow_read_write();
+        mmio_dmi = true;
+    }
+};
+
 class bus_harness: public test_base
 {
 public:
     generic::memory mem1;
     generic::memory mem2;
+    generic::memory mem3;
     generic::bus bus;
+    generic::bus bus2;
 
     master_socket OUT;
+    master_socket OUT2;
+
+    prefetcher pf;
+    mmio_target mmio;
 
     bus_harness(const sc_module_name& nm):
         test_base(nm),
         mem1("MEM1", 0x2000),
         mem2("MEM2", 0x2000),
+        mem3("MEM3", 0x2000),
         bus("BUS"),
-        OUT("OUT") {
+        bus2("BUS2"),
+        OUT("OUT"),
+        OUT2("OUT2"),
+        pf("PF"),
+        mmio("MMIO") {
 
         mem1.CLOCK.stub(100 * MHz);
         mem2.CLOCK.stub(100 * MHz);
+        mem3.CLOCK.stub(100 * MHz);
         bus.CLOCK.stub(100 * MHz);
+        bus2.CLOCK.stub(100 * MHz);
+        pf.CLOCK.stub(100 * MHz);
+        mmio.CLOCK.stub(100 * MHz);
         CLOCK.stub(100 * MHz);
 
         mem1.RESET.stub();
         mem2.RESET.stub();
+        mem3.RESET.stub();
         bus.RESET.stub();
+        bus2.RESET.stub();
+        pf.RESET.stub();
+        mmio.RESET.stub();
         RESET.stub();
 
         bus.bind(OUT);
+        bus.bind(OUT2);
+        bus.bind(pf.OUT);
         bus.bind(mem1.IN, 0x0000, 0x1fff, 0);
         bus.bind(mem2.IN, 0x2000, 0x3fff, 0);
+
+        // nested bus: 0x10000..0x13fff -> BUS2 0x1000..0x4fff
+        bus.bind(bus2.IN.next(), 0x10000, 0x13fff, 0x1000);
+        bus2.bind(mem3.IN, 0x2000, 0x3fff, 0);
+
+        bus.bind(mmio.IN, 0x20000, 0x20fff, 0);
     }
 
     virtual void run_test() override {
+        ASSERT_EQ(pf.OUT.dmi().get_entries().size(), 3)
+            << "bus did not provide DMI regions for prefetching";
+        EXPECT_EQ(pf.OUT.dmi().get_entries()[2].get_start_address(), 0x11000)
+            << "prefetched DMI region of nested bus has wrong start";
+
         ASSERT_OK(OUT.writew<u32>(0x0000, 0x11111111ul))
             << "cannot write 0x0000 (mem1 + 0x0)";
         ASSERT_OK(OUT.writew<u32>(0x0004, 0xfffffffful))
@@ -90,11 +149,106 @@ public:
                   OUT.dmi().get_entries()[1].get_dmi_ptr())
             << "bus forwarded overlapping DMI pointers";
 
+        bus.map(0, 0x8000, 0x8fff, 0x1000, "MEM1 alias");
+        ASSERT_OK(OUT.writew<u32>(0x8004, 0xabcdabcdul))
+            << "cannot write 0x8004 (mem1 + 0x1004)";
+        ASSERT_OK(OUT.readw<u32>(0x1004, data))
+            << "cannot read 0x1004 (mem1 + 0x1004)";
+        EXPECT_EQ(data, 0xabcdabcdul)
+            << "write to 0x8004 did not end up at mem1 + 0x1004";
+        EXPECT_EQ(bus.lookup(range(0x8000, 0x8003)).peer, "MEM1 alias")
+            << "bus decoded 0x8000 to wrong mapping";
+        EXPECT_EQ(bus.lookup(range(0x1ffe, 0x2001)).port, -1)
+            << "bus decoded access crossing two mappings";
+
         mem1.unmap_dmi(0, 0x1fff);
         ASSERT_EQ(OUT.dmi().get_entries().size(), 1)
             << "bus did not forward DMI invalidation";
         EXPECT_EQ(OUT.dmi().get_entries()[0].get_start_address(), 0x2000)
             << "bus invalidated wrong DMI region";
+
+        ASSERT_OK(OUT.writew<u32>(0x11004, 0x12345678ul))
+            << "cannot write 0x11004 (bus2 + 0x2004, mem3 + 0x4)";
+        EXPECT_EQ(*(u32*)(mem3.get_data_ptr() + 4), 0x12345678ul)
+            << "write to 0x11004 did not end up at mem3 + 0x4";
+        ASSERT_AE(OUT.writew<u32>(0x10000, 0x1234ul))
+            << "bus reported success for writing to unmapped bus2 address";
+        ASSERT_AE(OUT.writew<u32>(0x12ffe, 0x1234ul))
+            << "bus reported success for writing beyond end of mem3";
+
+        ASSERT_EQ(OUT.dmi().get_entries().size(), 2)
+            << "bus did not forward DMI region of nested bus";
+        EXPECT_EQ(OUT.dmi().get_entries()[1].get_start_address(), 0x11000)
+            << "bus translated nested DMI start address incorrectly";
+        EXPECT_EQ(OUT.dmi().get_entries()[1].get_end_address(), 0x12fff)
+            << "bus translated nested DMI end address incorrectly";
+
+        mem3.unmap_dmi(0, 0x1fff);
+        ASSERT_EQ(OUT.dmi().get_entries().size(), 1)
+            << "bus did not forward DMI invalidation of nested bus";
+
+        // OUT2 never received DMI, so all of its invalidations got filtered
+        std::stringstream ss;
+        ASSERT_TRUE(bus.execute("mmap", std::vector<std::string>(), ss));
+        EXPECT_THAT(ss.str(), HasSubstr("filtered DMI invalidations: "));
+        EXPECT_THAT(ss.str(), Not(HasSubstr("filtered DMI invalidations: 0")))
+            << "bus forwarded DMI invalidation to initiator without DMI";
+
+        // full range invalidation must be clipped to the window of mem2
+        ASSERT_OK(OUT.readw<u32>(0x0000, data))
+            << "cannot read 0x0000 (mem1 + 0x0)";
+        ASSERT_EQ(OUT.dmi().get_entries().size(), 2)
+            << "bus did not provide DMI for mem1 again";
+        (*mem2.IN)->invalidate_direct_mem_ptr(0, ~0ull);
+        ASSERT_EQ(OUT.dmi().get_entries().size(), 1)
+            << "bus did not forward full range DMI invalidation";
+        EXPECT_EQ(OUT.dmi().get_entries()[0].get_start_address(), 0x0000)
+            << "bus invalidated DMI region outside of mapped window";
+
+        ASSERT_OK(OUT.writew<u32>(0x20004, 0x1234abcdul))
+            << "cannot write 0x20004 (mmio + 0x4)";
+        EXPECT_EQ(mmio.DATA, 0x1234abcdul)
+            << "write to 0x20004 did not end up in mmio register";
+        ASSERT_EQ(OUT.get_num_mmio_handles(), 1)
+            << "target did not grant MMIO handle";
+
+        ASSERT_OK(OUT.readw<u32>(0x20004, data))
+            << "cannot read 0x20004 via MMIO handle";
+        EXPECT_EQ(data, 0x1234abcdul)
+            << "read invalid data from 0x20004 via MMIO handle";
+        ASSERT_AE(OUT.readw<u32>(0x20008, data))
+            << "MMIO handle reported success for unmapped register";
+
+        mmio.IN.invalidate_dmi();
+        EXPECT_EQ(OUT.get_num_mmio_handles(), 0)
+            << "bus did not forward MMIO handle invalidation";
+
+        // partial overlaps are accepted, earlier mappings keep priority
+        bus.map(1, 0x8800, 0x97ff, 0, "MEM2 overlap");
+        EXPECT_EQ(bus.lookup(range(0x8804, 0x8807)).peer, "MEM1 alias")
+            << "later mapping took priority over earlier one";
+        EXPECT_EQ(bus.lookup(range(0x9004, 0x9007)).peer, "MEM2 overlap")
+            << "bus did not map remainder of overlapping mapping";
+        EXPECT_EQ(bus.lookup(range(0x9004, 0x9007)).addr.start, 0x8800)
+            << "bus did not look up original overlapping mapping";
+        EXPECT_EQ(bus.lookup(range(0x8ffc, 0x9003)).peer, "MEM2 overlap")
+            << "access spanning clipped mappings changed its target";
+
+        u64 wide = 0;
+        ASSERT_OK(OUT.writew<u64>(0x8ffc, 0x1122334455667788ull))
+            << "cannot write across clipped mappings at 0x8ffc";
+        ASSERT_OK(OUT.readw<u64>(0x27fc, wide))
+            << "cannot read 0x27fc (mem2 + 0x7fc)";
+        EXPECT_EQ(wide, 0x1122334455667788ull)
+            << "write across clipped mappings did not end up in mem2";
+
+        // memory map is printed as bound, sorted by address
+        std::stringstream mm;
+        ASSERT_TRUE(bus.execute("mmap", std::vector<std::string>(), mm));
+        EXPECT_THAT(mm.str(), HasSubstr("\n2: 00008000..00008fff -> "
+                                        "00001000 .. 00001fff MEM1 alias"));
+        EXPECT_THAT(mm.str(), HasSubstr("\n3: 00008800..000097ff -> "
+                                        "MEM2 overlap"));
     }
 
 };
@@ -50,6 +50,55 @@ public:
         EXPECT_GT(OUT.dmi().get_entries().size(), 0)
             << "did not get DMI access to memory";
 
+        u32 val = 5;
+        ASSERT_OK(OUT.atomicw(VCML_ATOMIC_ADD, 0x8, val))
+            << "cannot perform atomic add via DMI";
+        EXPECT_EQ(val, 0u) << "atomic add returned wrong old value";
+        val = 7;
+        ASSERT_OK(OUT.atomicw(VCML_ATOMIC_CAS, 0x8, val, 5u))
+            << "cannot perform atomic compare-and-swap via DMI";
+        EXPECT_EQ(val, 5u) << "atomic cas returned wrong old value";
+        EXPECT_EQ(*(u32*)(mem.get_data_ptr() + 8), 7u)
+            << "atomic cas did not update memory";
+
+        mem.IN.exmem().add_lock(1, range(0x8, 0xb));
+        val = 3;
+        ASSERT_OK(OUT.atomicw(VCML_ATOMIC_MAXU, 0x8, val, 0u, SBI_NODMI))
+            << "cannot perform atomic max via transport";
+        EXPECT_EQ(val, 7u) << "atomic max returned wrong old value";
+        val = 0xf0;
+        ASSERT_OK(OUT.atomicw(VCML_ATOMIC_OR, 0x8, val, 0u, SBI_NODMI))
+            << "cannot perform atomic or via transport";
+        EXPECT_EQ(val, 7u) << "atomic or returned wrong old value";
+        EXPECT_EQ(*(u32*)(mem.get_data_ptr() + 8), 0xf7u)
+            << "atomic or did not update memory";
+        EXPECT_FALSE(mem.IN.exmem().has_locks())
+            << "atomic access did not clear exclusive reservation";
+
+        u16 half = 1;
+        EXPECT_EQ(OUT.atomicw(VCML_ATOMIC_SWAP, 0x9, half),
+                  TLM_GENERIC_ERROR_RESPONSE)
+            << "misaligned atomic access was permitted";
+
+        // exclusive reads revoke DMI to the whole granule, so that plain
+        // stores anywhere in it still clear the reservation
+        EXPECT_EQ(mem.IN.exmem().get_granule(), 128)
+            << "exmon_granule property was not applied";
+        ASSERT_OK(OUT.readw(0x40, val)) << "cannot read from address 0x40";
+        ASSERT_OK(OUT.readw(0x40, val, SBI_EXCL))
+            << "cannot perform exclusive read from address 0x40";
+        EXPECT_TRUE(mem.IN.exmem().has_lock(0, range(0x0, 0x7f)))
+            << "reservation does not cover the whole granule";
+        for (const tlm_dmi& dmi : OUT.dmi().get_entries()) {
+            EXPECT_FALSE(range(dmi).overlaps(range(0x0, 0x7f)))
+                << "DMI to reserved granule was not revoked";
+        }
+
+        ASSERT_OK(OUT.writew(0x7c, 0x12345678u))
+            << "cannot write to address 0x7c";
+        EXPECT_FALSE(mem.IN.exmem().has_locks())
+            << "store to reserved granule did not clear the reservation";
+
         mem.readonly = true;
 
         ASSERT_CE(OUT.writew(0x0, 0xfefefefe, SBI_NODMI))
@@ -71,6 +120,9 @@ public:
 };
 
 TEST(generic_memory, access) {
+    property_provider prov;
+    prov.add("harness.mem.exmon_granule", "128");
+
     test_harness test("harness");
     sc_core::sc_start();
 }
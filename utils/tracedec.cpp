@@ -0,0 +1,210 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright 2020 Jan Henrik Weinstock                                        *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License");            *
+ * you may not use this file except in compliance with the License.           *
+ * You may obtain a copy of the License at                                    *
+ *                                                                            *
+ *     http://www.apache.org/licenses/LICENSE-2.0                             *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "vcml/logging/trace_format.h"
+
+using namespace vcml;
+
+static const char* response_str(i8 response) {
+    switch (response) {
+    case  1: return "TLM_OK_RESPONSE";
+    case  0: return "TLM_INCOMPLETE_RESPONSE";
+    case -1: return "TLM_GENERIC_ERROR_RESPONSE";
+    case -2: return "TLM_ADDRESS_ERROR_RESPONSE";
+    case -3: return "TLM_COMMAND_ERROR_RESPONSE";
+    case -4: return "TLM_BURST_ERROR_RESPONSE";
+    case -5: return "TLM_BYTE_ENABLE_ERROR_RESPONSE";
+    default: return "TLM_UNKNOWN_RESPONSE";
+    }
+}
+
+static const char* command_str(u8 command) {
+    switch (command) {
+    case 0:  return "RD";
+    case 1:  return "WR";
+    default: return "IG";
+    }
+}
+
+static void usage(const char* arg0) {
+    fprintf(stderr, "Usage: %s [options] <trace file> [output file]\n", arg0);
+    fprintf(stderr, "  -c | --csv    Output comma separated values\n");
+    fprintf(stderr, "  -d | --delta  Include delta cycle in text output\n");
+    fprintf(stderr, "  -h | --help   Print this message\n");
+}
+
+static bool read_record(FILE* f, trace_record& rec) {
+    return fread(&rec, sizeof(rec), 1, f) == 1;
+}
+
+static bool read_names(FILE* f, std::vector<std::string>& names) {
+    trace_record rec;
+    while (read_record(f, rec)) {
+        if (rec.type != TRACE_RECORD_NAME)
+            continue;
+
+        std::string name;
+        for (u32 i = 0; i < trace_name_records(rec.size); i++) {
+            trace_record chars;
+            if (!read_record(f, chars))
+                return false;
+            name.append((const char*)&chars, sizeof(chars));
+        }
+
+        name.resize(rec.size);
+        if (names.size() <= rec.origin)
+            names.resize(rec.origin + 1);
+        names[rec.origin] = name;
+    }
+
+    return true;
+}
+
+static void print_text(FILE* out, const trace_record& rec,
+                       const std::string& org, size_t& namelen,
+                       bool delta) {
+    fprintf(out, "[T %lu.%09lu", (unsigned long)(rec.time / 1000000000ull),
+            (unsigned long)(rec.time % 1000000000ull));
+    if (delta)
+        fprintf(out, " <%lu>", (unsigned long)rec.delta);
+    fprintf(out, "]");
+
+    if (!org.empty()) {
+        if (namelen < org.length())
+            namelen = org.length();
+        fprintf(out, " %s:%*s", org.c_str(),
+                (int)(namelen - org.length()), "");
+    }
+
+    fprintf(out, "%s %s 0x%016lx [",
+            rec.flags & TRACE_FLAG_FORWARD ? ">>" : "<<",
+            command_str(rec.command), (unsigned long)rec.addr);
+
+    if (rec.size == 0)
+        fprintf(out, "<no data>");
+    for (u32 i = 0; i < rec.nbytes; i++)
+        fprintf(out, i ? " %02x" : "%02x", rec.data[i]);
+    if (rec.size > rec.nbytes)
+        fprintf(out, " ...");
+
+    fprintf(out, "] (%s)\n", response_str(rec.response));
+}
+
+static void print_csv(FILE* out, const trace_record& rec,
+                      const std::string& org) {
+    fprintf(out, "%lu,%lu,%s,%s,%s,0x%016lx,%u,%s,",
+            (unsigned long)rec.time, (unsigned long)rec.delta, org.c_str(),
+            rec.flags & TRACE_FLAG_FORWARD ? "fw" : "bw",
+            command_str(rec.command), (unsigned long)rec.addr, rec.size,
+            response_str(rec.response));
+    for (u32 i = 0; i < rec.nbytes; i++)
+        fprintf(out, "%02x", rec.data[i]);
+    fprintf(out, "\n");
+}
+
+int main(int argc, char** argv) {
+    bool csv = false;
+    bool delta = false;
+    const char* input = nullptr;
+    const char* output = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-c") || !strcmp(argv[i], "--csv")) {
+            csv = true;
+        } else if (!strcmp(argv[i], "-d") || !strcmp(argv[i], "--delta")) {
+            delta = true;
+        } else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+            usage(argv[0]);
+            return EXIT_SUCCESS;
+        } else if (input == nullptr) {
+            input = argv[i];
+        } else if (output == nullptr) {
+            output = argv[i];
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (input == nullptr) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE* in = fopen(input, "rb");
+    if (in == nullptr) {
+        fprintf(stderr, "cannot open %s: %s\n", input, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    trace_header header;
+    if (fread(&header, sizeof(header), 1, in) != 1 ||
+        memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) ||
+        header.version != TRACE_VERSION ||
+        header.record_size != sizeof(trace_record)) {
+        fprintf(stderr, "%s is not a supported trace file\n", input);
+        fclose(in);
+        return EXIT_FAILURE;
+    }
+
+    // names may be defined after their first use by other threads
+    std::vector<std::string> names;
+    if (!read_names(in, names))
+        fprintf(stderr, "warning: %s is truncated\n", input);
+
+    FILE* out = stdout;
+    if (output != nullptr && (out = fopen(output, "w")) == nullptr) {
+        fprintf(stderr, "cannot open %s: %s\n", output, strerror(errno));
+        fclose(in);
+        return EXIT_FAILURE;
+    }
+
+    if (csv)
+        fprintf(out, "time_ns,delta,origin,dir,cmd,addr,size,resp,data\n");
+
+    size_t namelen = 20;
+    fseek(in, sizeof(header), SEEK_SET);
+
+    trace_record rec;
+    while (read_record(in, rec)) {
+        if (rec.type == TRACE_RECORD_NAME) {
+            fseek(in, trace_name_records(rec.size) * sizeof(rec), SEEK_CUR);
+            continue;
+        }
+
+        std::string org;
+        if (rec.origin < names.size())
+            org = names[rec.origin];
+
+        if (csv)
+            print_csv(out, rec, org);
+        else
+            print_text(out, rec, org, namelen, delta);
+    }
+
+    if (out != stdout)
+        fclose(out);
+    fclose(in);
+
+    return EXIT_SUCCESS;
+}